@@ -0,0 +1,50 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <vector>
+#include "TaskStorage.h"
+
+// Minimal harness for minitasks_bench. Every measurement is printed as one JSON object
+// per line on stdout, so results can be appended to a file and tracked across commits.
+namespace bench {
+
+void report(const char* name, qint64 tasks, qint64 iterations, qint64 elapsedNs);
+void sink(qint64 value); // Consumes a result so the loop producing it can't be optimized away
+
+template <typename Fn>
+qint64 timeNs(Fn&& fn)
+{
+    QElapsedTimer timer;
+    timer.start();
+    fn();
+    return timer.nsecsElapsed();
+}
+
+// Times iterations calls of fn, cycling through inputs, and sinks the sum of what it returns
+template <typename Input, typename Fn>
+qint64 timeEach(const QList<Input>& inputs, int iterations, Fn&& fn)
+{
+    qint64 total = 0;
+    qint64 ns = timeNs([&]() {
+        for (int i = 0; i < iterations; ++i) {
+            total += static_cast<qint64>(fn(inputs[i % inputs.size()]));
+        }
+    });
+    sink(total);
+    return ns;
+}
+
+// Deterministic task mix: ~10% with an elapsed alarm, ~10% with a future one, ~30% completed
+std::vector<TaskItem> makeTasks(int count, qint64 now);
+
+void runStorageBenchmarks(const std::vector<int>& sizes);
+void runParserBenchmarks(int iterations);
+void runOrderingBenchmarks(const std::vector<int>& sizes);
+void runSearchBenchmarks(const std::vector<int>& sizes);
+void runRefreshBenchmarks();
+
+}
+
+#endif // BENCH_H
@@ -0,0 +1,85 @@
+// Headless benchmark suite for minitasks_core.
+// Usage: minitasks_bench [--sizes 1000,10000,100000,1000000] [--parse-iterations N] [--only storage|parser|ordering|search|refresh]
+#include "Bench.h"
+#include "utils/FuzzyMatcher.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QStringList>
+#include <QThreadPool>
+#include <cstdio>
+
+namespace bench {
+
+void report(const char* name, qint64 tasks, qint64 iterations, qint64 elapsedNs)
+{
+    double nsPerOp = iterations > 0 ? static_cast<double>(elapsedNs) / iterations : 0.0;
+    double opsPerSec = nsPerOp > 0 ? 1e9 / nsPerOp : 0.0;
+    std::printf("{\"benchmark\":\"%s\",\"tasks\":%lld,\"iterations\":%lld,\"ns_per_op\":%.1f,\"ops_per_sec\":%.1f}\n",
+                name, tasks, iterations, nsPerOp, opsPerSec);
+    std::fflush(stdout);
+}
+
+namespace {
+volatile qint64 s_sink = 0;
+}
+
+void sink(qint64 value)
+{
+    s_sink = s_sink + value;
+}
+
+std::vector<TaskItem> makeTasks(int count, qint64 now)
+{
+    std::vector<TaskItem> tasks;
+    tasks.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        TaskItem t;
+        t.id = static_cast<TaskId>(i + 1);
+        t.text = QString("Task number %1 with some representative text").arg(i);
+        t.isCompleted = i % 10 >= 7;
+        if (i % 10 == 0) {
+            t.alarmTime = now - 60000;  // Elapsed
+        } else if (i % 10 == 1) {
+            t.alarmTime = now + 60000 * (i % 500 + 1);
+        }
+        tasks.push_back(t);
+    }
+    return tasks;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("minitasks_bench");
+
+    std::vector<int> sizes = { 1000, 10000, 100000, 1000000 };
+    int parseIterations = 200000;
+    QString only;
+
+    const QStringList args = app.arguments();
+    for (int i = 1; i + 1 < args.size(); i += 2) {
+        if (args[i] == "--sizes") {
+            sizes.clear();
+            for (const QString& s : args[i + 1].split(',', Qt::SkipEmptyParts)) {
+                sizes.push_back(s.toInt());
+            }
+        } else if (args[i] == "--parse-iterations") {
+            parseIterations = args[i + 1].toInt();
+        } else if (args[i] == "--only") {
+            only = args[i + 1];
+        }
+    }
+
+    std::printf("{\"suite\":\"minitasks_bench\",\"qt\":\"%s\",\"threads\":%d,\"simd\":\"%s\",\"timestamp\":\"%s\"}\n",
+                qVersion(), QThreadPool::globalInstance()->maxThreadCount(), FuzzyMatcher::instructionSet(),
+                qPrintable(QDateTime::currentDateTimeUtc().toString(Qt::ISODate)));
+
+    if (only.isEmpty() || only == "parser") bench::runParserBenchmarks(parseIterations);
+    if (only.isEmpty() || only == "ordering") bench::runOrderingBenchmarks(sizes);
+    if (only.isEmpty() || only == "search") bench::runSearchBenchmarks(sizes);
+    if (only.isEmpty() || only == "refresh") bench::runRefreshBenchmarks();
+    if (only.isEmpty() || only == "storage") bench::runStorageBenchmarks(sizes);
+    return 0;
+}
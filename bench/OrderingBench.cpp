@@ -0,0 +1,61 @@
+#include "Bench.h"
+#include "utils/TaskOrdering.h"
+#include <QDateTime>
+#include <algorithm>
+
+namespace {
+
+// The copy-free stable_sort that displayOrder's counting partition replaced, as the baseline
+std::vector<TaskId> stableSortOrder(const std::vector<TaskItem>& tasks, qint64 now)
+{
+    std::vector<size_t> order(tasks.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&tasks, now](size_t a, size_t b) {
+        return TaskOrdering::bucketOf(tasks[a], now) < TaskOrdering::bucketOf(tasks[b], now);
+    });
+
+    std::vector<TaskId> ids;
+    ids.reserve(order.size());
+    for (size_t i : order) {
+        ids.push_back(tasks[i].id);
+    }
+    return ids;
+}
+
+template <typename Fn>
+void runOrdering(const char* name, const std::vector<TaskItem>& tasks, int iterations, Fn order)
+{
+    size_t rows = 0;
+    qint64 ns = bench::timeNs([&]() {
+        for (int i = 0; i < iterations; ++i) {
+            rows += order().size();
+        }
+    });
+    bench::sink(static_cast<qint64>(rows));
+    bench::report(name, static_cast<qint64>(tasks.size()), iterations, ns);
+}
+
+}
+
+namespace bench {
+
+void runOrderingBenchmarks(const std::vector<int>& sizes)
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    for (int size : sizes) {
+        std::vector<TaskItem> tasks = makeTasks(size, now);
+        int iterations = size >= 100000 ? 3 : 20;
+
+        runOrdering("ordering.display_order", tasks, iterations, [&]() {
+            return TaskOrdering::displayOrder(tasks, now);
+        });
+        runOrdering("ordering.display_order_stable_sort_baseline", tasks, iterations, [&]() {
+            return stableSortOrder(tasks, now);
+        });
+    }
+}
+
+}
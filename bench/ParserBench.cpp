@@ -0,0 +1,72 @@
+#include "Bench.h"
+#include "utils/SmartParser.h"
+#include <QRegularExpression>
+#include <QDateTime>
+#include <QStringList>
+
+namespace {
+
+// The regex-based parser SmartParser replaced, kept verbatim as the baseline
+ParsedTask legacyParse(const QString& rawText)
+{
+    ParsedTask result;
+    result.cleanText = rawText;
+    result.alarmTime = 0;
+
+    QRegularExpression re(R"(\b(?:in(?: exactly)?)\s+(\d+)\s*(m|min|mins|minutes|h|hr|hrs|hours)\b)", QRegularExpression::CaseInsensitiveOption);
+    QRegularExpressionMatch match = re.match(rawText);
+
+    if (match.hasMatch()) {
+        int amount = match.captured(1).toInt();
+        QString unit = match.captured(2).toLower();
+
+        qint64 msToAdd = 0;
+        if (unit.startsWith("m")) {
+            msToAdd = amount * 60 * 1000LL;
+        } else if (unit.startsWith("h")) {
+            msToAdd = amount * 60 * 60 * 1000LL;
+        }
+
+        if (msToAdd > 0) {
+            result.alarmTime = QDateTime::currentMSecsSinceEpoch() + msToAdd;
+        }
+    }
+
+    return result;
+}
+
+const QStringList& parserInputs()
+{
+    static const QStringList inputs = {
+        "Buy milk",
+        "Call mom in 15m",
+        "Stand-up in exactly 2 hours",
+        "Review the quarterly planning document before Friday",
+        "Stretch in 45 mins",
+        "Pick up the parcel from the post office in 1 hr",
+        "Reply to the thread about the release checklist",
+        "Water the plants",
+    };
+    return inputs;
+}
+
+template <typename Fn>
+void runParse(const char* name, int iterations, Fn parse)
+{
+    qint64 ns = bench::timeEach(parserInputs(), iterations, [&parse](const QString& input) {
+        return parse(input).alarmTime != 0;
+    });
+    bench::report(name, 0, iterations, ns);
+}
+
+}
+
+namespace bench {
+
+void runParserBenchmarks(int iterations)
+{
+    runParse("parser.parse", iterations, [](const QString& s) { return SmartParser::parse(s); });
+    runParse("parser.parse_regex_baseline", iterations, [](const QString& s) { return legacyParse(s); });
+}
+
+}
@@ -0,0 +1,35 @@
+#include "Bench.h"
+#include "RefreshCoalescer.h"
+#include <QCoreApplication>
+#include <cstdio>
+
+namespace bench {
+
+// Bursts of storage changes per event loop turn, as a scripted delete of ten items makes.
+// Besides the timing, prints how many refreshes the coalescer saved.
+void runRefreshBenchmarks()
+{
+    const int turns = 1000;
+    struct Case { int burst; const char* name; };
+    for (const Case& c : { Case{ 1, "refresh.burst_1" }, Case{ 10, "refresh.burst_10" }, Case{ 100, "refresh.burst_100" } }) {
+        const int burst = c.burst;
+        RefreshCoalescer coalescer;
+
+        qint64 ns = timeNs([&]() {
+            for (int turn = 0; turn < turns; ++turn) {
+                for (int i = 0; i < burst; ++i) {
+                    coalescer.request();
+                }
+                QCoreApplication::processEvents();
+            }
+            coalescer.flush();
+        });
+
+        report(c.name, burst, turns, ns);
+        std::printf("{\"benchmark\":\"refresh.coalesced\",\"burst\":%d,\"requests\":%lld,\"refreshes\":%lld,\"coalesced\":%lld}\n",
+                    burst, coalescer.requestCount(), coalescer.refreshCount(), coalescer.coalescedCount());
+        std::fflush(stdout);
+    }
+}
+
+}
@@ -0,0 +1,66 @@
+#include "Bench.h"
+#include "utils/FuzzyMatcher.h"
+#include "utils/TrigramIndex.h"
+#include <QDateTime>
+#include <QStringList>
+
+namespace {
+
+// What a user might type, one query per keystroke-sized refresh
+const QStringList& searchQueries()
+{
+    static const QStringList queries = {
+        "number 4242",
+        "representative",
+        "tsk 99 txt",
+        "nmbr 12345",
+        "some rep",
+        "missing words",
+    };
+    return queries;
+}
+
+template <typename Fn>
+void runSearch(const char* name, int size, Fn search)
+{
+    const QStringList& queries = searchQueries();
+    bench::report(name, size, queries.size(), bench::timeEach(queries, static_cast<int>(queries.size()), search));
+}
+
+}
+
+namespace bench {
+
+void runSearchBenchmarks(const std::vector<int>& sizes)
+{
+    for (int size : sizes) {
+        std::vector<TaskItem> tasks = makeTasks(size, QDateTime::currentMSecsSinceEpoch());
+
+        // Baseline: what a filter without an index would do on every keystroke
+        runSearch("search.contains_naive", size, [&tasks](const QString& query) {
+            size_t hits = 0;
+            for (const TaskItem& t : tasks) {
+                hits += t.text.contains(query, Qt::CaseInsensitive);
+            }
+            return hits;
+        });
+
+        TrigramIndex index;
+        report("search.trigram_build", size, 1, timeNs([&]() {
+            for (const TaskItem& t : tasks) index.insert(t.id, t.text);
+        }));
+        runSearch("search.trigram", size, [&index](const QString& query) {
+            return index.search(query).size();
+        });
+
+        FuzzyMatcher fuzzy;
+        report("search.fuzzy_build", size, 1, timeNs([&]() {
+            for (const TaskItem& t : tasks) fuzzy.insert(t.id, t.text);
+        }));
+        runSearch("search.fuzzy", size, [&fuzzy](const QString& query) {
+            return fuzzy.search(query).size();
+        });
+    }
+}
+
+}
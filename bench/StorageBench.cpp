@@ -0,0 +1,134 @@
+#include "Bench.h"
+#include "JsonTaskReader.h"
+#include <QTemporaryDir>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <algorithm>
+
+namespace bench {
+
+namespace {
+
+// Toggles the completed flag of the first `count` tasks, one mutation per simulated click,
+// and waits until the writer thread has put all of them on disk
+// syncEach waits for every write, otherwise the writer may merge queued snapshots into one
+qint64 toggleTasks(TaskStorage& storage, int count, bool syncEach = false)
+{
+    std::vector<TaskId> ids;
+    for (int i = 0; i < count; ++i) {
+        ids.push_back(storage.tasks()[i].id);
+    }
+    return timeNs([&]() {
+        for (TaskId id : ids) {
+            storage.setCompleted(id, !storage.find(id)->isCompleted);
+            if (syncEach) storage.sync();
+        }
+        storage.sync();
+    });
+}
+
+// Time from constructing the storage until the first rows could be painted
+qint64 timeToFirstRows(const QString& directory)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    TaskStorage storage(directory);
+    bool ready = !storage.isLoading() || !storage.tasks().empty();
+    QObject::connect(&storage, &TaskStorage::tasksAppended, [&ready]() { ready = true; });
+    QObject::connect(&storage, &TaskStorage::loadFinished, [&ready]() { ready = true; });
+    while (!ready) {
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    }
+    return timer.nsecsElapsed();
+}
+
+// Reads a whole tasks.json with the chunked reader, the way the loader thread does
+size_t parseFile(const QString& filename, bool parallel)
+{
+    JsonTaskReader reader(filename);
+    reader.setParallel(parallel);
+    reader.open();
+    size_t count = 0;
+    std::vector<TaskItem> chunk;
+    while (!reader.atEnd()) {
+        chunk.clear();
+        reader.readChunk(chunk, 32768);
+        count += chunk.size();
+    }
+    return count;
+}
+
+}
+
+void runStorageBenchmarks(const std::vector<int>& sizes)
+{
+    for (int size : sizes) {
+        QTemporaryDir dir;
+        if (!dir.isValid()) return;
+
+        {
+            TaskStorage storage(dir.path());
+            storage.setStorageMode(TaskStorage::StorageMode::Snapshot);
+            storage.setWritePolicy(TaskStorage::WritePolicy::WriteBack);
+
+            qint64 ns = timeNs([&]() {
+                for (int i = 0; i < size; ++i) {
+                    storage.add(QString("Task number %1 with some representative text").arg(i));
+                }
+            });
+            report("storage.add", size, size, ns);
+
+            report("storage.save", size, 1, timeNs([&]() { storage.sync(); }));
+        }
+
+        report("storage.load", size, 1, timeNs([&]() {
+            TaskStorage storage(dir.path());
+            storage.waitForLoad();
+        }));
+        report("storage.load_first_rows", size, 1, timeToFirstRows(dir.path()));
+
+        // Parser alone, one thread vs the global pool (maxThreadCount threads)
+        const QString jsonFile = dir.filePath("tasks.json");
+        report("storage.parse_sequential", size, 1, timeNs([&]() { parseFile(jsonFile, false); }));
+        report("storage.parse_parallel", size, 1, timeNs([&]() { parseFile(jsonFile, true); }));
+
+        if (size == 0) continue;
+
+        {
+            // Old behaviour: every click rewrites the whole file
+            TaskStorage storage(dir.path());
+            storage.setStorageMode(TaskStorage::StorageMode::Snapshot);
+            storage.setWritePolicy(TaskStorage::WritePolicy::WriteThrough);
+            int clicks = std::min(size, size >= 100000 ? 5 : 50);
+            report("storage.mutate_snapshot", size, clicks, toggleTasks(storage, clicks, true));
+        }
+
+        {
+            // Journaled: every click appends one record; compaction kept out of the measurement
+            TaskStorage storage(dir.path());
+            storage.setStorageMode(TaskStorage::StorageMode::Journaled);
+            storage.setWritePolicy(TaskStorage::WritePolicy::WriteThrough);
+            storage.setCompactionThreshold(1 << 30, 1LL << 40);
+            int clicks = std::min(size, 1000);
+            report("storage.mutate_journaled", size, clicks, toggleTasks(storage, clicks));
+        }
+
+        {
+            // Same list converted to the memory-mapped binary snapshot
+            TaskStorage storage(dir.path());
+            storage.setStorageMode(TaskStorage::StorageMode::Snapshot);
+            report("storage.save_binary", size, 1, timeNs([&]() {
+                storage.setSnapshotFormat(TaskStorage::SnapshotFormat::Binary);
+                storage.sync();
+            }));
+        }
+
+        report("storage.load_binary", size, 1, timeNs([&]() {
+            TaskStorage storage(dir.path());
+            storage.waitForLoad();
+        }));
+    }
+}
+
+}
@@ -0,0 +1,55 @@
+#ifndef ALARMSCHEDULER_H
+#define ALARMSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <limits>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "TaskStorage.h"
+
+// Keeps every pending alarm in an ordered (deadline, id) index and arms one precise
+// single-shot timer for the earliest, so nothing wakes up while no alarm is pending.
+// Updates are O(log n), and entries leave the index for the due set at their deadline.
+// The index doubles as the upcoming schedule: range queries cost O(log n + k).
+class AlarmScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Entry = std::pair<qint64, TaskId>; // (deadline, id)
+
+    explicit AlarmScheduler(QObject *parent = nullptr);
+
+    void reset(const std::vector<TaskItem>& tasks);
+    void schedule(TaskId id, qint64 alarmTime); // alarmTime 0 cancels
+    void cancel(TaskId id);
+
+    bool hasDue() const { return !m_due.empty(); }
+    bool isDue(TaskId id) const { return m_due.count(id) > 0; }
+
+    // Pending alarms, earliest first
+    std::vector<Entry> upcoming(size_t limit) const;
+    std::vector<Entry> pendingBetween(qint64 from, qint64 to, size_t limit = std::numeric_limits<size_t>::max()) const;
+    size_t pendingCount() const { return m_schedule.size(); }
+
+signals:
+    void alarmDue(TaskId id);
+    void dueChanged(bool hasDue);
+    void scheduleChanged(); // The set of pending alarms changed
+
+private:
+    void onTimeout();
+    void arm();
+    void setDue(TaskId id, bool due);
+
+    std::set<Entry> m_schedule;
+    std::unordered_map<TaskId, qint64> m_pending; // Deadline per scheduled task, to find its entry
+    std::unordered_set<TaskId> m_due;             // Tasks whose deadline has passed
+    QTimer m_timer;
+};
+
+#endif // ALARMSCHEDULER_H
@@ -3,8 +3,12 @@
 
 #include <QWidget>
 #include <QTimer>
+#include <QPixmap>
 #include <QPaintEvent>
 
+// Minimal clock for the SidePanel. The ring is cached in a pixmap so a tick only draws
+// the hands, and ticking only happens while the clock is visible, on the second (or
+// minute) boundary.
 class AnalogClock : public QWidget
 {
     Q_OBJECT
@@ -12,11 +16,20 @@ class AnalogClock : public QWidget
 public:
     explicit AnalogClock(QWidget *parent = nullptr);
 
+    void setShowSeconds(bool show); // Off = low-power mode, repaints once a minute
+
 protected:
     void paintEvent(QPaintEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
 
 private:
+    void scheduleTick();
+    const QPixmap& face();
+
     QTimer *timer;
+    QPixmap m_face; // Static ring, rebuilt when the device pixel ratio changes
+    bool m_showSeconds = true;
 };
 
 #endif // ANALOGCLOCK_H
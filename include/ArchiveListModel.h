@@ -0,0 +1,28 @@
+#ifndef ARCHIVELISTMODEL_H
+#define ARCHIVELISTMODEL_H
+
+#include <QAbstractListModel>
+#include <vector>
+#include "TaskStorage.h"
+
+// Read-only rows over archived tasks, with the same roles as TaskListModel so the
+// popup's delegate paints them. Rows are the tasks themselves: opening history costs
+// no per-row objects, and clear() hands the memory back once history closes.
+class ArchiveListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit ArchiveListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    void setTasks(std::vector<TaskItem> tasks);
+    void clear();
+
+private:
+    std::vector<TaskItem> m_tasks;
+};
+
+#endif // ARCHIVELISTMODEL_H
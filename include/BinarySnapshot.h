@@ -0,0 +1,38 @@
+#ifndef BINARYSNAPSHOT_H
+#define BINARYSNAPSHOT_H
+
+#include <QFile>
+#include <QString>
+#include <vector>
+#include "TaskStorage.h"
+
+// Compact binary alternative to tasks.json: a fixed header, one 40-byte record per task
+// and a heap holding every text as UTF-16. A loaded snapshot stays memory-mapped and
+// task texts point straight into the mapping, so loading copies no string data at all.
+class BinarySnapshot
+{
+public:
+    // Streams the snapshot through QSaveFile, so it is replaced atomically like tasks.json
+    static bool write(const QString& filename, const std::vector<TaskItem>& tasks, qint64 seq);
+
+    // Maps the file and validates its header and section sizes, in O(1). Records are only
+    // checked as they are read. The snapshot must stay alive as long as any text taken
+    // from it, see TaskStorage::loadFromDisk.
+    bool open(const QString& filename);
+
+    qint64 seq() const { return m_seq; }
+    size_t count() const { return m_count; }
+    // Zero-copy, the text is QString::fromRawData. False if the record's text lies outside the heap.
+    bool taskAt(size_t index, TaskItem& task) const;
+
+private:
+    QFile m_file;
+    const uchar* m_records = nullptr;
+    const QChar* m_heap = nullptr;
+    size_t m_recordSize = 0; // Version 1 files have shorter records
+    size_t m_count = 0;
+    quint64 m_heapSize = 0;
+    qint64 m_seq = 0;
+};
+
+#endif // BINARYSNAPSHOT_H
@@ -4,11 +4,12 @@
 #include <QWidget>
 #include <QMouseEvent>
 #include <QPaintEvent>
-#include <QSvgWidget>
 #include <QTimer>
 #include "TaskPopup.h"
 #include "TaskStorage.h"
 #include "SidePanel.h"
+#include "AlarmScheduler.h"
+#include "SvgSprite.h"
 
 class FloatingButton : public QWidget
 {
@@ -23,26 +24,31 @@ protected:
     void mouseMoveEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
     void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
     void paintEvent(QPaintEvent *event) override;
 
 private slots:
     void handleTaskAdded(const QString& task);
-    void handleTaskDeleted(int index);
-    void handleTaskDone(int index, bool completed);
-    void handleTaskSnoozed(int index);
-    void handleTaskEdited(int index, const QString& newText);
-    void checkAlarms();
+    void handleTaskDeleted(TaskId id);
+    void handleTaskDone(TaskId id, bool completed);
+    void handleTaskSnoozed(TaskId id);
+    void handleTaskEdited(TaskId id, const QString& newText);
 
 private:
+    void syncAlarm(TaskId id);
     void repositionPopup();
     void togglePopup();
     void updateSvgState(bool urgent);
+    SvgSprite& currentSprite();
 
     TaskPopup* m_popup;
     SidePanel* m_sidePanel;
     TaskStorage m_storage;
-    QSvgWidget* m_svgWidget;
-    QTimer* m_alarmTimer;
+    AlarmScheduler m_alarms;
+    SvgSprite m_normalSprite;
+    SvgSprite m_urgentSprite;
+    QTimer m_animationTimer;
+    int m_frame = 0;
     qint64 m_lastPopupHideTime = 0;
     bool m_isAlarmUrgent = false;
     
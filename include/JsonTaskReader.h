@@ -0,0 +1,56 @@
+#ifndef JSONTASKREADER_H
+#define JSONTASKREADER_H
+
+#include <QFile>
+#include <QByteArray>
+#include <utility>
+#include <vector>
+#include "TaskStorage.h"
+
+// Incremental reader for tasks.json, in either the plain array form or the journaled
+// {"seq": N, "tasks": [...]} form. The file is read in fixed-size blocks and split at task
+// object boundaries by a cheap byte scan; only the objects of the current chunk are held
+// and parsed, so memory use doesn't grow with the file. Parsing a chunk can be spread over
+// the global thread pool, the results keep their file order.
+class JsonTaskReader
+{
+public:
+    explicit JsonTaskReader(const QString& filename);
+
+    bool open();
+    bool atEnd() const { return m_atEnd; }
+    void setParallel(bool parallel) { m_parallel = parallel; }
+    void readChunk(std::vector<TaskItem>& out, size_t maxTasks); // Appends up to maxTasks tasks
+    qint64 seq() const { return m_seq; } // Final once atEnd(), 0 for the array form
+
+private:
+    bool scan(size_t target); // false when the block is used up
+    void parseObjects(std::vector<TaskItem>& out) const;
+
+    QFile m_file;
+    QByteArray m_block;
+    int m_pos = 0;
+    bool m_atEnd = false;
+    bool m_parallel = false;
+
+    // Task objects of the current chunk, as (offset, length) into m_raw
+    QByteArray m_raw;
+    std::vector<std::pair<int, int>> m_objects;
+
+    // Scanner state, carried across blocks
+    int m_depth = 0;
+    int m_taskDepth = -1;      // Nesting depth of the tasks array, -1 until it's found
+    bool m_rootIsObject = false;
+    bool m_inString = false;
+    bool m_escape = false;
+    bool m_capturingKey = false;
+    QByteArray m_string;       // Last key seen directly in the root object
+    QByteArray m_key;
+    bool m_readingSeq = false;
+    QByteArray m_number;
+    int m_objectStart = -1;    // Start of the current task object in m_block, -1 if none
+    int m_rawStart = 0;        // Where that object starts in m_raw
+    qint64 m_seq = 0;
+};
+
+#endif // JSONTASKREADER_H
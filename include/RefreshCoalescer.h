@@ -0,0 +1,39 @@
+#ifndef REFRESHCOALESCER_H
+#define REFRESHCOALESCER_H
+
+#include <QObject>
+#include <QTimer>
+
+// Dirty flag for views that rebuild from a model. Every request() within one event loop
+// turn, or within the window if one is set, ends in a single refresh() signal.
+// The counters show how much work the coalescing saved.
+class RefreshCoalescer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RefreshCoalescer(QObject *parent = nullptr);
+
+    void request();
+    void flush(); // Refreshes now if a request is pending, e.g. before the view is read
+    void cancel(); // Drops a pending request, for when the view was rebuilt some other way
+    bool isPending() const { return m_pending; }
+
+    void setWindow(int ms); // 0 (the default) refreshes on the next event loop turn
+    int window() const { return m_timer.interval(); }
+
+    qint64 requestCount() const { return m_requests; }
+    qint64 refreshCount() const { return m_refreshes; }
+    qint64 coalescedCount() const { return m_requests - m_refreshes - (m_pending ? 1 : 0); }
+
+signals:
+    void refresh();
+
+private:
+    QTimer m_timer;
+    bool m_pending = false;
+    qint64 m_requests = 0;
+    qint64 m_refreshes = 0;
+};
+
+#endif // REFRESHCOALESCER_H
@@ -6,24 +6,32 @@
 #include <QVBoxLayout>
 #include <QListWidget>
 #include <QLabel>
+#include <QPointer>
 #include "TaskStorage.h"
+#include "AlarmScheduler.h"
+#include "RefreshCoalescer.h"
 
+// Lists the next upcoming alarms, read straight from the scheduler's ordered index.
+// Alarms drop off on their own when they fire, since the scheduler ages them out.
 class SidePanel : public QWidget
 {
     Q_OBJECT
 
 public:
-    explicit SidePanel(QWidget *parent = nullptr);
-    void reloadSchedule(const std::vector<TaskItem>& tasks);
+    explicit SidePanel(const AlarmScheduler* alarms, QWidget *parent = nullptr);
+    void reloadSchedule();
+    void setRefreshWindow(int ms) { m_refresh.setWindow(ms); }
 
 signals:
-    void scrollTargetRequested(int taskIndex);
+    void scrollTargetRequested(TaskId taskId);
 
 protected:
     void paintEvent(QPaintEvent *event) override;
-    
+
 private:
+    QPointer<const AlarmScheduler> m_alarms; // Owned by FloatingButton, which may go first on exit
     QListWidget* m_scheduleList;
+    RefreshCoalescer m_refresh; // A chunked load or a burst of edits changes the schedule many times in a row
 };
 
 #endif // SIDEPANEL_H
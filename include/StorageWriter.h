@@ -0,0 +1,93 @@
+#ifndef STORAGEWRITER_H
+#define STORAGEWRITER_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QFile>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "TaskStorage.h"
+
+// Performs every TaskStorage disk write on its own thread, in the order the writes were
+// requested. Requests are queued and drained in batches: a burst of journal appends
+// becomes one write, and a snapshot followed by a newer one in the same batch is skipped.
+// Failed writes are kept and retried, and success is reported through persisted().
+//
+// Snapshots are replaced atomically and synced by QSaveFile. Journal appends are
+// group-committed: they reach the OS right away, but share one fsync per commit window,
+// and persisted() is only emitted once that fsync is done.
+class StorageWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    // snapshotFilenames lists every file a snapshot may live in; writing one removes the others
+    StorageWriter(const QStringList& snapshotFilenames, const QString& journalFilename);
+    ~StorageWriter(); // Finishes outstanding writes, then stops the thread
+
+    // These only queue the request and return right away
+    void appendJournal(const QByteArray& records, qint64 lastSeq);
+    void writeSnapshot(std::vector<TaskItem> tasks, qint64 seq, bool journaled,
+                       TaskStorage::SnapshotFormat format, const QString& filename);
+    void appendArchive(const QByteArray& records, const QString& filename); // Appended and synced at once
+    void syncNow(); // Ends the current commit window early
+
+    void setGroupCommitWindow(int ms) { m_groupCommitMs = ms; } // 0 syncs after every batch
+    void waitForIdle(); // Blocks until every request made so far has been attempted
+
+signals:
+    // Emitted from the writer thread
+    void persisted(qint64 seq);          // Every mutation up to seq is durably on disk
+    void compactionFinished(bool ok);    // A journaled snapshot was written, or failed to be
+    void archiveFinished(bool ok);       // An archive append is durably on disk, or failed
+
+private:
+    struct Request {
+        enum Type { Append, Snapshot, Sync, Archive } type;
+        qint64 seq;
+        QByteArray records;          // Append, Archive
+        std::vector<TaskItem> tasks; // Snapshot
+        bool journaled = false;      // Snapshot: from a compaction, reported by compactionFinished
+        TaskStorage::SnapshotFormat format = TaskStorage::SnapshotFormat::Json;
+        QString filename;            // Snapshot, Archive
+    };
+
+    static bool writeSnapshotFile(const Request& request);
+    static bool writeArchive(const Request& request);
+
+    void enqueue(Request request);
+    void drain(); // Writer thread only
+    bool writeJournal(const QByteArray& data);
+    void scheduleSync();
+    void syncJournal();
+    void closeJournal();
+
+    QThread m_thread;
+    QStringList m_snapshotFilenames;
+    QString m_journalFilename;
+    std::atomic<int> m_groupCommitMs { 200 };
+
+    QMutex m_mutex;
+    QWaitCondition m_idle;
+    std::vector<Request> m_queue;
+    bool m_drainScheduled = false;
+    bool m_busy = false;
+
+    // Writer thread state
+    std::unique_ptr<QFile> m_journal; // Kept open between appends, closed before it's removed
+    QByteArray m_unwritten;           // Journal records from failed appends, retried first
+    qint64 m_unwrittenSeq = 0;
+    qint64 m_unsyncedSeq = 0;         // Highest seq written to the journal but not fsync'd yet
+    bool m_syncScheduled = false;
+    bool m_retryScheduled = false;
+    std::optional<Request> m_failedSnapshot;
+};
+
+#endif // STORAGEWRITER_H
@@ -0,0 +1,32 @@
+#ifndef SVGSPRITE_H
+#define SVGSPRITE_H
+
+#include <QByteArray>
+#include <QPixmap>
+#include <QSize>
+#include <QSvgRenderer>
+#include <map>
+#include <vector>
+
+// An animated SVG rasterized once into a strip of frames, per device pixel ratio.
+// Playback only blits pixmaps, so the vector scene (gradients, filters) is never
+// re-rendered while the animation loops.
+class SvgSprite
+{
+public:
+    SvgSprite(const QByteArray& svg, const QSize& size, int framesPerSecond);
+
+    void prepare(qreal dpr); // Renders the strip for this ratio if it isn't cached yet
+    int frameCount() const { return m_frameCount; }
+    int frameInterval() const; // ms between frames, 0 if the SVG isn't animated
+    const QPixmap& frame(int index, qreal dpr);
+
+private:
+    QSvgRenderer m_renderer; // Parsed once and kept for new ratios
+    QSize m_size;
+    int m_frameCount = 1;
+    int m_durationMs = 0;
+    std::map<qreal, std::vector<QPixmap>> m_strips;
+};
+
+#endif // SVGSPRITE_H
@@ -0,0 +1,84 @@
+#ifndef TASKITEMDELEGATE_H
+#define TASKITEMDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QAbstractItemView>
+#include <QPoint>
+#include <QPersistentModelIndex>
+#include <QFont>
+#include <QHash>
+#include "TaskStorage.h"
+
+// Paints task rows for TaskListModel and hit-tests the hover actions (snooze, done,
+// delete, edit), so a row costs no widgets at all. The actions are painted on the
+// hovered row only, and moving the mouse repaints just the rows whose hover changed.
+class TaskItemDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit TaskItemDelegate(QAbstractItemView *view);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+    void setFlashedId(TaskId id); // Highlight border used by scroll-to navigation, 0 clears it
+    void setHighlight(const QString& text); // Marks case-insensitive matches in row text, empty clears it
+    void setReadOnly(bool readOnly); // No hover actions and no editing, for archived rows
+
+public slots:
+    // Connected to the model's dataChanged: QListView keeps the row heights it measured,
+    // so rows whose text or urgency now needs a different height are reported here
+    void remeasure(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+
+signals:
+    void deleteRequested(TaskId id);
+    void doneRequested(TaskId id, bool isCompleted);
+    void snoozeRequested(TaskId id);
+    void editRequested(TaskId id, const QString& text);
+
+protected:
+    bool editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem& option, const QModelIndex& index) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    enum class Action { None, Snooze, Done, Delete };
+
+    // Fonts derived from the view font once, indexed by row state (normal, urgent, completed)
+    struct Fonts {
+        QFont text[3];
+        QFont snoozeGlyph;
+        QFont glyph;
+    };
+    const Fonts& fonts(const QFont& viewFont) const;
+
+    // Measured once per text and wrap width, dropped when the font or DPI changes
+    struct TextLayout {
+        QString displayText; // Truncated to roughly 3 lines
+        int rowHeight = 38;  // 38, 60 or 84 px for 1, 2 or 3+ wrapped lines
+    };
+    const TextLayout& textLayout(const QString& text, bool isUrgent, const QFont& viewFont) const;
+
+    static QString displayText(const QString& text);
+    void drawHighlightedText(QPainter *painter, const QRect& rect, const QString& text, const QFont& font) const;
+    static QRect cardRect(const QRect& rowRect, bool hovered);
+    static QRect buttonRect(const QRect& rowRect, Action action);
+    Action actionAt(const QRect& rowRect, const QPoint& pos, bool isUrgent) const;
+    bool isHovered(const QRect& rowRect) const;
+    void updateRow(const QModelIndex& index);
+
+    QAbstractItemView* m_view;
+    QPoint m_hoverPos = QPoint(-1, -1);
+    QPersistentModelIndex m_hoverIndex; // Row under the mouse, follows it through model changes
+    Action m_hoverAction = Action::None;
+    TaskId m_flashedId = 0;
+    QString m_highlight;
+    bool m_readOnly = false;
+    mutable Fonts m_fonts;
+    mutable QFont m_viewFont;
+    mutable bool m_fontsValid = false;
+    mutable int m_layoutDpi = 0;
+    mutable QHash<QString, TextLayout> m_layouts[2]; // Plain rows, urgent rows
+};
+
+#endif // TASKITEMDELEGATE_H
@@ -0,0 +1,97 @@
+#ifndef TASKLISTMODEL_H
+#define TASKLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "TaskStorage.h"
+#include "AlarmScheduler.h"
+#include "RefreshCoalescer.h"
+#include "utils/TrigramIndex.h"
+#include "utils/FuzzyMatcher.h"
+
+// Read-only list model over TaskStorage. Rows are a display-ordered list of task ids,
+// so no TaskItem is copied and the view only ever asks about the rows it shows.
+// Storage change signals only mark their task pending. The pending set is applied once
+// per event loop turn (or refresh window) as row inserts, removes, moves and one
+// dataChanged, so the view keeps its scroll position and hover state, and a burst
+// of changes costs one pass and one repaint.
+// A non-empty filter keeps only tasks whose text contains it, looked up in a trigram
+// index that is built on the first search and then kept current by the same signals.
+// When nothing contains the filter, the rows fall back to fuzzy matches, best first.
+// With a scheduler, urgency is its due set and an alarm going off moves just that row.
+class TaskListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        IdRole = Qt::UserRole + 1,
+        CompletedRole,
+        UrgentRole,
+        AlarmTimeRole
+    };
+
+    explicit TaskListModel(const TaskStorage* storage, const AlarmScheduler* alarms = nullptr, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    void reload(); // Rebuilds the rows in O(n), only needed without a scheduler to refresh urgency
+    void setFilter(const QString& text); // Empty shows every task
+    const QString& filter() const { return m_filter; }
+    int rowOf(TaskId id) const; // -1 if the task has no row, O(1) unless rows shifted since the last call
+    const TaskItem* taskAt(int row) const;
+    bool isUrgent(const TaskItem& task) const;
+
+    // Rows lag storage until the pending changes are applied, flush before relying on them
+    void flushPendingChanges() { m_refresh.flush(); }
+    void setRefreshWindow(int ms) { m_refresh.setWindow(ms); }
+    const RefreshCoalescer& refreshes() const { return m_refresh; }
+
+private slots:
+    void onTaskInserted(TaskId id);
+    void onTaskChanged(TaskId id);
+    void onTaskRemoved(TaskId id);
+    void onTasksAppended(int first, int count);
+    void onUrgencyChanged(TaskId id);
+    void onStorageReloaded();
+    void applyPendingChanges();
+
+private:
+    // Display order is (bucket, storage position), see TaskOrdering
+    using SortKey = std::pair<int, int>;
+    SortKey sortKey(TaskId id) const;
+    int lowerBound(int first, int last, const SortKey& key) const;
+    void insertRow(TaskId id);
+    void removeRows(int first, int last);
+    void rowsShiftedFrom(int row);
+    void resetRowIndex();
+    void repositionRow(TaskId id);
+    void markPending(TaskId id);
+    void sortRows();
+    void ensureIndex();
+    bool passesFilter(TaskId id) const;
+    bool refreshFuzzyResults();
+    std::vector<TaskId> filteredOrder();
+
+    const TaskStorage* m_storage;
+    const AlarmScheduler* m_alarms;
+    std::vector<TaskId> m_rows;
+    // Row of each shown task. Entries before m_rowByIdValid are exact; the rest are
+    // re-indexed on the next lookup, since an insert or remove shifts every row after it.
+    mutable std::unordered_map<TaskId, int> m_rowById;
+    mutable int m_rowByIdValid = 0;
+    qint64 m_reloadTime = 0; // Without a scheduler, urgency is evaluated once per reload to match the row order
+    QString m_filter;
+    TrigramIndex m_index;
+    FuzzyMatcher m_fuzzy;
+    bool m_indexed = false;
+    bool m_fuzzyResults = false; // Rows are ranked fuzzy matches rather than display order
+    std::unordered_set<TaskId> m_pending; // Tasks whose row may be stale
+    RefreshCoalescer m_refresh;
+};
+
+#endif // TASKLISTMODEL_H
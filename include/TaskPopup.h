@@ -3,27 +3,33 @@
 
 #include <QWidget>
 #include <QLineEdit>
-#include <QListWidget>
+#include <QListView>
 #include <QVBoxLayout>
 #include <QPaintEvent>
+#include <QTimer>
 
 #include "TaskStorage.h"
+#include "AlarmScheduler.h"
+
+class TaskListModel;
+class ArchiveListModel;
+class TaskItemDelegate;
 
 class TaskPopup : public QWidget
 {
     Q_OBJECT
 
 public:
-    explicit TaskPopup(QWidget *parent = nullptr);
-    void reloadTasks(const std::vector<TaskItem>& tasks);
-    void scrollToTask(int targetIndex);
+    explicit TaskPopup(const TaskStorage* storage, const AlarmScheduler* alarms, QWidget *parent = nullptr);
+    void scrollToTask(TaskId targetId);
+    void setRefreshWindow(int ms); // How long storage changes are collected before the list catches up
 
 signals:
     void taskAdded(const QString& task);
-    void taskDeleted(int index);
-    void taskDone(int index, bool completed);
-    void taskSnoozed(int index);
-    void taskEdited(int index, const QString& newText);
+    void taskDeleted(TaskId id);
+    void taskDone(TaskId id, bool completed);
+    void taskSnoozed(TaskId id);
+    void taskEdited(TaskId id, const QString& newText);
     void popupHidden();
 
 protected:
@@ -34,11 +40,23 @@ protected:
 
 private slots:
     void onReturnPressed();
-    void onTaskEditRequested(int index, const QString& text);
+    void onTaskEditRequested(TaskId id, const QString& text);
+    void onInputChanged(const QString& text);
 
 private:
+    void setSearchMode(bool enabled);
+    void setHistoryMode(bool enabled);
+
+    const TaskStorage* m_storage;
     QLineEdit* m_inputField;
-    QListWidget* m_taskList;
+    QListView* m_taskList;
+    TaskListModel* m_model;
+    TaskItemDelegate* m_delegate;
+    QTimer* m_flashTimer;
+    bool m_searchMode = false;
+    QString m_draft; // Unsent task text, put back when search mode ends
+    ArchiveListModel* m_historyModel; // Archived tasks, read from disk each time history opens
+    bool m_historyMode = false;
 };
 
 #endif // TASKPOPUP_H
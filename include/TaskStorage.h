@@ -1,28 +1,202 @@
 #ifndef TASKSTORAGE_H
 #define TASKSTORAGE_H
 
+#include <QObject>
 #include <QString>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QTimer>
+#include <QMutex>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
+class StorageWriter;
+class QThread;
+
+// Persistent task identifier, stored in tasks.json. 0 is never a valid id.
+using TaskId = quint64;
+
 struct TaskItem {
+    TaskId id = 0;
     QString text;
     bool isCompleted;
     qint64 alarmTime = 0; // Epoch milliseconds, 0 if not an alarm
+    qint64 completedAt = 0; // Epoch milliseconds of the last completion, 0 if open or unknown
 };
 
-class TaskStorage
+// Writes tasks.json. A negative seq writes the plain array format, otherwise an object
+// that records the sequence number of the last journal record it includes.
+bool saveInternal(const QString& filename, const std::vector<TaskItem>& tasks, qint64 seq = -1);
+QJsonObject taskToJson(const TaskItem& t);
+TaskItem taskFromJson(const QJsonObject& obj);
+
+// Owns the task list. The in-memory vector is the source of truth: reads never
+// touch disk, and mutations are flushed to tasks.json according to the write policy.
+// In journaled mode each mutation is flushed as one appended line in tasks.journal,
+// and the journal is folded back into tasks.json by a background compaction.
+// Flushing only hands the data to a StorageWriter thread; persisted() reports when it
+// has actually reached the disk.
+//
+// A snapshot, JSON or binary, is read on a background thread and published in chunks through
+// tasksAppended(), so the first rows show while the rest loads. The first mutation
+// (or waitForLoad()) waits for the remainder, since it has to apply on top of the journal.
+// Chunks arrive in file order and all of them are kept: the list is the source of truth,
+// so memory still grows with the file. Urgent tasks only move to the top as they arrive.
+//
+// Completed tasks older than the archive age move to tasks.archive, an append-only file
+// of JSON lines that is only read when history is asked for, so the hot list stays small.
+class TaskStorage : public QObject
 {
+    Q_OBJECT
+
 public:
-    TaskStorage();
-    std::vector<TaskItem> load();
-    void add(const QString& task);
-    void update(int index, const QString& newText);
-    void setCompleted(int index, bool completed);
-    void snooze(int index);
-    void remove(int index);
+    enum class WritePolicy {
+        WriteThrough, // Hand every mutation to the writer thread immediately, no write-back delay
+        WriteBack     // Coalesce mutations and flush once after a short delay
+    };
+
+    enum class StorageMode {
+        Snapshot, // Rewrite the whole tasks.json on every flush
+        Journaled // Append mutation records to tasks.journal, compact periodically
+    };
+
+    enum class SnapshotFormat {
+        Json,  // tasks.json, human-readable
+        Binary // tasks.0.bin / tasks.1.bin, memory-mapped on load, see BinarySnapshot
+    };
+
+    explicit TaskStorage(QObject *parent = nullptr); // Uses the per-user AppData directory
+    explicit TaskStorage(const QString& directory, QObject *parent = nullptr);
+    ~TaskStorage();
+
+    bool isLoading() const { return m_loading; }
+    void waitForLoad(); // Blocks until the whole snapshot and journal are loaded
+
+    const std::vector<TaskItem>& tasks() const { return m_tasks; } // Grows while loading
+    const TaskItem* find(TaskId id) const;
+    int indexOf(TaskId id) const; // Position in tasks(), -1 if unknown
+
+    TaskId add(const QString& task); // Returns the new task's id, 0 if nothing was added
+    void update(TaskId id, const QString& newText);
+    void setCompleted(TaskId id, bool completed);
+    void snooze(TaskId id);
+    void remove(TaskId id);
+
+    void setWritePolicy(WritePolicy policy, int delayMs = 500);
+    WritePolicy writePolicy() const { return m_writePolicy; }
+    void flush(); // Queue pending changes for writing now, regardless of policy
+    void sync();  // Flush, then block until everything is written and synced (or failed)
+    void setGroupCommitWindow(int ms); // Journal appends within this window share one fsync
+
+    qint64 currentSeq() const { return m_seq; }
+    qint64 persistedSeq() const { return m_persistedSeq; }
+    bool hasUnsavedChanges() const { return m_persistedSeq < m_seq; }
+
+    void setStorageMode(StorageMode mode);
+    StorageMode storageMode() const { return m_mode; }
+    void setCompactionThreshold(int maxRecords, qint64 maxBytes);
+
+    // Loading picks whichever format is newest on disk; this only affects what gets written
+    void setSnapshotFormat(SnapshotFormat format);
+    SnapshotFormat snapshotFormat() const { return m_format; }
+    bool exportJson(const QString& filename); // Plain tasks.json array, whatever the format
+
+    // Completed tasks are archived once completed for longer than this, checked hourly. 0 (the default)
+    // turns archiving off. Tasks completed before completion times were recorded are never archived.
+    void setArchiveAge(qint64 ms);
+    qint64 archiveAge() const { return m_archiveAge; }
+    std::vector<TaskItem> loadArchive() const; // Reads tasks.archive, oldest first
+
+signals:
+    // Fine-grained change notifications, emitted after the in-memory list was updated
+    void taskInserted(TaskId id);
+    void taskChanged(TaskId id);
+    void taskRemoved(TaskId id);
+
+    // Loading: rows [first, first + count) of tasks() were appended. reloaded() means the
+    // loaded list changed wholesale (ids assigned, journal replayed) and views should rebuild.
+    void tasksAppended(int first, int count);
+    void reloaded();
+    void loadFinished();
+
+    // Durability acknowledgement: every mutation up to seq is on disk
+    void persisted(qint64 seq);
 
 private:
+    void loadFromDisk();
+    // Fills chunk with up to maxCount tasks, returns false once the source is used up
+    using ChunkReader = std::function<bool(std::vector<TaskItem>& chunk, size_t maxCount)>;
+
+    bool openBinary(const QString& filename);
+    void startStreamingLoad(ChunkReader readChunk, std::function<qint64()> seq);
+    void drainLoadedChunks();
+    void completeLoad(qint64 snapshotSeq);
+    void queueSnapshot(bool journaled);
+    void rebuildIndex();
+    void eraseAt(int index);
+    void markDirty();
+
+    void appendRecord(QJsonObject record);
+    void applyRecord(const QJsonObject& record);
+    void replayJournal();
+    void maybeCompact();
+    void startCompaction();
+    void onCompactionFinished(bool ok);
+    void onPersisted(qint64 seq);
+    void archiveCompleted();
+    void onArchiveFinished(bool ok);
+    void eraseArchived(const std::vector<TaskId>& ids);
+    static TaskId readArchivedNextId(const QString& filename);
+
     QString m_filename;
+    QString m_binaryFilenames[2];
+    int m_binarySlot = 0; // Binary snapshots are written here, never to the mapped slot
+    SnapshotFormat m_format = SnapshotFormat::Json;
+    std::vector<TaskItem> m_tasks;
+    std::unordered_map<TaskId, size_t> m_indexById;
+    TaskId m_nextId = 1;
+    WritePolicy m_writePolicy = WritePolicy::WriteBack;
+    QTimer m_flushTimer;
+    bool m_dirty = false;
+    std::unique_ptr<StorageWriter> m_writer;
+    qint64 m_persistedSeq = 0;
+
+    // Journal state
+    QString m_journalFilename;
+    StorageMode m_mode = StorageMode::Journaled;
+    qint64 m_seq = 0;              // Sequence number of the last mutation (journaled in journaled mode)
+    QByteArray m_pendingJournal;   // Records not yet appended to disk
+    int m_journalRecords = 0;      // Including records still queued on the writer
+    qint64 m_journalBytes = 0;
+    int m_maxJournalRecords = 1000;
+    qint64 m_maxJournalBytes = 1024 * 1024;
+
+    // Streaming load state
+    QThread* m_loaderThread = nullptr;
+    QMutex m_loadMutex;
+    std::vector<std::vector<TaskItem>> m_loadedChunks; // Parsed, not yet appended to m_tasks
+    bool m_loadDrainScheduled = false;
+    std::atomic<bool> m_abortLoad { false };
+    qint64 m_loadedSeq = 0;  // Set by the loader thread before it finishes
+    bool m_loading = false;
+    bool m_publishing = true; // Whether appended chunks are announced with tasksAppended()
+
+    // Compaction state. The journal counters restart at zero when a compaction is queued
+    // and get the folded-in counts back if it fails.
+    bool m_compacting = false;
+    int m_recordsBeforeCompaction = 0;
+    qint64 m_bytesBeforeCompaction = 0;
+
+    // Archive state. Tasks leave the hot list only once the writer reports their archive
+    // append durable, and only if they haven't changed since.
+    QString m_archiveFilename;
+    TaskId m_archivedNextId = 1; // Archived tasks may use any id below this, so it is never reused
+    qint64 m_archiveAge = 0;
+    QTimer m_archiveTimer;
+    std::vector<TaskItem> m_archiving; // Copies sent to the writer, awaiting archiveFinished
 };
 
 #endif // TASKSTORAGE_H
@@ -0,0 +1,48 @@
+#ifndef FUZZYMATCHER_H
+#define FUZZYMATCHER_H
+
+#include <QString>
+#include <unordered_map>
+#include <vector>
+#include "TaskStorage.h"
+
+// fzf-style fuzzy matching: a query matches when its characters appear in order, and
+// the match is scored by how tight it is and whether it starts words. Every task's
+// case-folded text lives in one contiguous UTF-16 buffer. A 64-bit character mask per
+// task rejects most candidates outright, and the in-order character search runs 8
+// (SSE2) or 16 (AVX2) code units at a time, with a scalar fallback elsewhere.
+class FuzzyMatcher {
+public:
+    struct Match {
+        TaskId id;
+        int score;
+    };
+
+    void clear();
+    void insert(TaskId id, const QString& text);
+    void update(TaskId id, const QString& text);
+    void remove(TaskId id);
+
+    // Best score first, ties in insertion order
+    std::vector<Match> search(const QString& query) const;
+    static int score(const QString& text, const QString& query); // 0 if it doesn't match
+    static const char* instructionSet(); // "avx2", "sse2" or "scalar"
+
+private:
+    struct Entry {
+        TaskId id; // 0 once removed, the text stays until the next compaction
+        quint32 offset;
+        quint32 length;
+        quint64 mask;
+    };
+    static quint64 maskOf(const char16_t* s, qsizetype length);
+    static int score(const char16_t* text, int length, const char16_t* query, int queryLength);
+    void compact();
+
+    std::vector<char16_t> m_chars;
+    std::vector<Entry> m_entries;
+    std::unordered_map<TaskId, size_t> m_slots;
+    size_t m_removed = 0;
+};
+
+#endif // FUZZYMATCHER_H
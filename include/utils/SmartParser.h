@@ -8,9 +8,15 @@ struct ParsedTask {
     qint64 alarmTime; // Epoch ms, 0 if no alarm
 };
 
+// Single-pass scanner for alarm phrases. The first phrase found wins:
+//   "in [exactly] N <unit>"            relative, units: m/min/mins/minute/minutes, h/hr/hrs/hour/hours, d/day/days
+//   "at 17:30", "at 9am", "at 9:15 pm" next occurrence of that wall-clock time
+//   "tomorrow [at] 9am"                that time on the next day
+// Word boundaries and digits are ASCII, as with the previous regex.
 class SmartParser {
 public:
     static ParsedTask parse(const QString& rawText);
+    static ParsedTask parse(const QString& rawText, qint64 now);
 };
 
 #endif // SMARTPARSER_H
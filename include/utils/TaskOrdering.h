@@ -0,0 +1,51 @@
+#ifndef TASKORDERING_H
+#define TASKORDERING_H
+
+#include <vector>
+#include "TaskStorage.h"
+
+// Display ordering shared by the task list and the benchmarks:
+// urgent (open with an elapsed alarm), then open, then completed, each in storage order.
+class TaskOrdering {
+public:
+    enum Bucket { Urgent = 0, Open = 1, Completed = 2, BucketCount = 3 };
+
+    static Bucket bucketOf(const TaskItem& task, qint64 now);
+    static Bucket bucketOf(const TaskItem& task, bool urgent);
+    static bool isUrgent(const TaskItem& task, qint64 now);
+
+    // Task ids in display order, urgency judged by the clock
+    static std::vector<TaskId> displayOrder(const std::vector<TaskItem>& tasks, qint64 now);
+
+    // Same, with urgency from isUrgent(const TaskItem&), e.g. a scheduler's due set.
+    // A counting partition: O(n), one predicate call per task, no TaskItem copied.
+    template <typename IsUrgent>
+    static std::vector<TaskId> displayOrder(const std::vector<TaskItem>& tasks, IsUrgent isUrgent);
+};
+
+template <typename IsUrgent>
+std::vector<TaskId> TaskOrdering::displayOrder(const std::vector<TaskItem>& tasks, IsUrgent isUrgent)
+{
+    std::vector<unsigned char> buckets(tasks.size());
+    size_t offsets[BucketCount] = {};
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        buckets[i] = static_cast<unsigned char>(bucketOf(tasks[i], isUrgent(tasks[i])));
+        offsets[buckets[i]]++;
+    }
+
+    // Bucket sizes become start positions; filling in storage order keeps each bucket stable
+    size_t start = 0;
+    for (size_t& offset : offsets) {
+        size_t count = offset;
+        offset = start;
+        start += count;
+    }
+
+    std::vector<TaskId> ids(tasks.size());
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        ids[offsets[buckets[i]]++] = tasks[i].id;
+    }
+    return ids;
+}
+
+#endif // TASKORDERING_H
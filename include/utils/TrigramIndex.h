@@ -0,0 +1,32 @@
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include <QString>
+#include <unordered_map>
+#include <vector>
+#include "TaskStorage.h"
+
+// Case-insensitive substring search over task text. Each text is split into overlapping
+// 3-character grams, and every gram keeps a sorted list of the ids containing it. A query
+// intersects the lists of its own grams and confirms the survivors with a substring check.
+// Tasks are inserted, updated and removed one at a time, an edit never rebuilds the index.
+class TrigramIndex {
+public:
+    void clear();
+    void insert(TaskId id, const QString& text);
+    void update(TaskId id, const QString& text);
+    void remove(TaskId id);
+
+    bool matches(TaskId id, const QString& query) const;
+    std::vector<TaskId> search(const QString& query) const; // Ascending ids
+    size_t size() const { return m_texts.size(); }
+
+private:
+    using Gram = quint64; // Three UTF-16 code units
+    static std::vector<Gram> gramsOf(const QString& folded);
+
+    std::unordered_map<Gram, std::vector<TaskId>> m_postings;
+    std::unordered_map<TaskId, QString> m_texts; // Case folded
+};
+
+#endif // TRIGRAMINDEX_H
@@ -0,0 +1,154 @@
+#include "AlarmScheduler.h"
+#include <QDateTime>
+#include <algorithm>
+
+namespace {
+// QTimer intervals are ints; far-off deadlines are approached in steps of at most a day,
+// which also bounds the drift from wall-clock changes while the timer is armed.
+const qint64 kMaxTimerInterval = 24LL * 60 * 60 * 1000;
+}
+
+AlarmScheduler::AlarmScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &AlarmScheduler::onTimeout);
+}
+
+void AlarmScheduler::reset(const std::vector<TaskItem>& tasks)
+{
+    bool hadDue = hasDue();
+    m_pending.clear();
+    m_due.clear();
+
+    std::vector<Entry> entries;
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (const auto& t : tasks) {
+        if (t.isCompleted || t.alarmTime <= 0) continue;
+        if (t.alarmTime <= now) {
+            m_due.insert(t.id);
+        } else {
+            m_pending[t.id] = t.alarmTime;
+            entries.emplace_back(t.alarmTime, t.id);
+        }
+    }
+
+    // Sorted input builds the set in linear time
+    std::sort(entries.begin(), entries.end());
+    m_schedule = std::set<Entry>(entries.begin(), entries.end());
+
+    arm();
+    emit scheduleChanged();
+    if (hadDue != hasDue()) {
+        emit dueChanged(hasDue());
+    }
+}
+
+void AlarmScheduler::schedule(TaskId id, qint64 alarmTime)
+{
+    if (alarmTime <= 0) {
+        cancel(id);
+        return;
+    }
+
+    auto it = m_pending.find(id);
+    if (alarmTime <= QDateTime::currentMSecsSinceEpoch()) {
+        if (it != m_pending.end()) {
+            m_schedule.erase({ it->second, id });
+            m_pending.erase(it);
+            arm();
+            emit scheduleChanged();
+        }
+        setDue(id, true);
+        return;
+    }
+
+    if (it != m_pending.end()) {
+        if (it->second == alarmTime) return;
+        m_schedule.erase({ it->second, id });
+    }
+    m_pending[id] = alarmTime;
+    m_schedule.insert({ alarmTime, id });
+
+    setDue(id, false);
+    arm();
+    emit scheduleChanged();
+}
+
+void AlarmScheduler::cancel(TaskId id)
+{
+    auto it = m_pending.find(id);
+    if (it != m_pending.end()) {
+        m_schedule.erase({ it->second, id });
+        m_pending.erase(it);
+        arm();
+        emit scheduleChanged();
+    }
+    setDue(id, false);
+}
+
+std::vector<AlarmScheduler::Entry> AlarmScheduler::upcoming(size_t limit) const
+{
+    std::vector<Entry> entries;
+    for (auto it = m_schedule.begin(); it != m_schedule.end() && entries.size() < limit; ++it) {
+        entries.push_back(*it);
+    }
+    return entries;
+}
+
+std::vector<AlarmScheduler::Entry> AlarmScheduler::pendingBetween(qint64 from, qint64 to, size_t limit) const
+{
+    std::vector<Entry> entries;
+    for (auto it = m_schedule.lower_bound({ from, 0 }); it != m_schedule.end() && it->first <= to && entries.size() < limit; ++it) {
+        entries.push_back(*it);
+    }
+    return entries;
+}
+
+void AlarmScheduler::arm()
+{
+    if (m_schedule.empty()) {
+        m_timer.stop(); // Nothing pending: no wakeups at all
+        return;
+    }
+
+    qint64 delay = m_schedule.begin()->first - QDateTime::currentMSecsSinceEpoch();
+    m_timer.start(static_cast<int>(std::clamp<qint64>(delay, 0, kMaxTimerInterval)));
+}
+
+void AlarmScheduler::onTimeout()
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    // Everything at or before now ages out of the schedule into the due set
+    bool changed = false;
+    while (!m_schedule.empty() && m_schedule.begin()->first <= now) {
+        TaskId id = m_schedule.begin()->second;
+        m_schedule.erase(m_schedule.begin());
+        m_pending.erase(id);
+        setDue(id, true);
+        changed = true;
+    }
+
+    // Also covers an early or clamped wakeup: the earliest entry is simply re-armed
+    arm();
+    if (changed) {
+        emit scheduleChanged();
+    }
+}
+
+void AlarmScheduler::setDue(TaskId id, bool due)
+{
+    bool hadDue = hasDue();
+    if (due) {
+        if (!m_due.insert(id).second) return;
+        emit alarmDue(id);
+    } else if (!m_due.erase(id)) {
+        return;
+    }
+
+    if (hadDue != hasDue()) {
+        emit dueChanged(hasDue());
+    }
+}
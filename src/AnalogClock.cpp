@@ -8,20 +8,79 @@ AnalogClock::AnalogClock(QWidget *parent)
 {
     setFixedSize(50, 50); // Small, ultra-minimal size to fit inside the 60px wide SidePanel
     
+    // Single-shot and re-armed every tick, so it stays on the wall-clock boundary
     timer = new QTimer(this);
+    timer->setSingleShot(true);
+    timer->setTimerType(Qt::PreciseTimer);
     connect(timer, &QTimer::timeout, this, [this]() {
-        update(); // Trigger a repaint every second
+        update();
+        scheduleTick();
     });
-    timer->start(1000);
     
     setAttribute(Qt::WA_TranslucentBackground);
 }
 
+void AnalogClock::setShowSeconds(bool show)
+{
+    if (show == m_showSeconds) return;
+    m_showSeconds = show;
+    if (isVisible()) {
+        update();
+        scheduleTick();
+    }
+}
+
+void AnalogClock::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    update(); // The hands may be minutes behind after being hidden
+    scheduleTick();
+}
+
+void AnalogClock::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    timer->stop();
+}
+
+void AnalogClock::scheduleTick()
+{
+    QTime time = QTime::currentTime();
+    int msIntoPeriod = m_showSeconds ? time.msec() : time.second() * 1000 + time.msec();
+    int period = m_showSeconds ? 1000 : 60000;
+    timer->start(period - msIntoPeriod);
+}
+
+const QPixmap& AnalogClock::face()
+{
+    qreal dpr = devicePixelRatioF();
+    if (!m_face.isNull() && m_face.devicePixelRatio() == dpr && m_face.deviceIndependentSize() == QSizeF(size())) {
+        return m_face;
+    }
+
+    m_face = QPixmap(size() * dpr);
+    m_face.setDevicePixelRatio(dpr);
+    m_face.fill(Qt::transparent);
+
+    QPainter painter(&m_face);
+    painter.setRenderHint(QPainter::Antialiasing);
+    
+    int side = qMin(width(), height());
+    painter.translate(width() / 2, height() / 2);
+    painter.scale(side / 100.0, side / 100.0);
+    
+    // Draw minimalist outer ring
+    painter.setPen(QPen(QColor(255, 255, 255, 40), 2));
+    painter.drawEllipse(-45, -45, 90, 90);
+    return m_face;
+}
+
 void AnalogClock::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event);
     
     QPainter painter(this);
+    painter.drawPixmap(0, 0, face());
     painter.setRenderHint(QPainter::Antialiasing);
     
     int side = qMin(width(), height());
@@ -30,10 +89,6 @@ void AnalogClock::paintEvent(QPaintEvent *event)
     
     QTime time = QTime::currentTime();
     
-    // Draw minimalist outer ring
-    painter.setPen(QPen(QColor(255, 255, 255, 40), 2));
-    painter.drawEllipse(-45, -45, 90, 90);
-    
     // Draw hour hand
     painter.setPen(Qt::NoPen);
     painter.setBrush(QColor(255, 255, 255, 200));
@@ -42,19 +97,21 @@ void AnalogClock::paintEvent(QPaintEvent *event)
     painter.drawRoundedRect(-2, -25, 4, 25, 2, 2);
     painter.restore();
     
-    // Draw minute hand
+    // Draw minute hand, it only moves on whole minutes in low-power mode
     painter.setBrush(QColor(165, 180, 252, 200)); // Indigo-300 tint for minutes
     painter.save();
-    painter.rotate(6.0 * (time.minute() + time.second() / 60.0));
+    painter.rotate(6.0 * (time.minute() + (m_showSeconds ? time.second() / 60.0 : 0.0)));
     painter.drawRoundedRect(-1.5, -35, 3, 35, 1.5, 1.5);
     painter.restore();
     
     // Draw second hand
-    painter.setBrush(QColor(135, 206, 235, 255)); // SkyBlue for seconds to match the selection flash
-    painter.save();
-    painter.rotate(6.0 * time.second());
-    painter.drawRect(-0.5, -40, 1, 40);
-    painter.restore();
+    if (m_showSeconds) {
+        painter.setBrush(QColor(135, 206, 235, 255)); // SkyBlue for seconds to match the selection flash
+        painter.save();
+        painter.rotate(6.0 * time.second());
+        painter.drawRect(-0.5, -40, 1, 40);
+        painter.restore();
+    }
     
     // Center dot
     painter.setBrush(QColor(255, 255, 255, 255));
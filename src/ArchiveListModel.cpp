@@ -0,0 +1,49 @@
+#include "ArchiveListModel.h"
+#include "TaskListModel.h"
+
+ArchiveListModel::ArchiveListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int ArchiveListModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) return 0;
+    return static_cast<int>(m_tasks.size());
+}
+
+QVariant ArchiveListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) return QVariant();
+    const TaskItem& task = m_tasks[index.row()];
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return task.text;
+    case TaskListModel::IdRole:
+        return QVariant::fromValue(task.id);
+    case TaskListModel::CompletedRole:
+        return task.isCompleted;
+    case TaskListModel::UrgentRole:
+        return false; // Nothing archived can ring
+    case TaskListModel::AlarmTimeRole:
+        return task.alarmTime;
+    default:
+        return QVariant();
+    }
+}
+
+void ArchiveListModel::setTasks(std::vector<TaskItem> tasks)
+{
+    beginResetModel();
+    m_tasks = std::move(tasks);
+    endResetModel();
+}
+
+void ArchiveListModel::clear()
+{
+    // Swapped out rather than cleared, so the capacity goes too
+    beginResetModel();
+    std::vector<TaskItem>().swap(m_tasks);
+    endResetModel();
+}
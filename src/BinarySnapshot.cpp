@@ -0,0 +1,137 @@
+#include "BinarySnapshot.h"
+#include <QSaveFile>
+#include <cstring>
+
+namespace {
+// On-disk layout, native byte order. Every section starts 8-byte aligned, so records
+// and UTF-16 text can be read in place from the mapping.
+struct Header {
+    char magic[4];       // "MTSB"
+    quint32 version;
+    quint32 byteOrder;   // kByteOrderMark as written, rejects files from other-endian machines
+    quint32 recordSize;
+    qint64 seq;          // Last mutation included, as in journaled tasks.json
+    quint64 count;
+    quint64 heapSize;    // In UTF-16 code units
+};
+
+struct Record {
+    quint64 id;
+    qint64 alarmTime;
+    quint64 textOffset;  // In UTF-16 code units from the start of the heap
+    quint32 textLength;
+    quint32 flags;
+    qint64 completedAt;  // Version 2, version 1 records end before it
+};
+
+static_assert(sizeof(Header) == 40, "Header layout is part of the file format");
+static_assert(sizeof(Record) == 40, "Record layout is part of the file format");
+
+const char kMagic[4] = { 'M', 'T', 'S', 'B' };
+const quint32 kVersion = 2;
+const quint32 kVersion1RecordSize = 32;
+const quint32 kByteOrderMark = 0x01020304;
+const quint32 kCompletedFlag = 0x1;
+const size_t kRecordChunk = 4096; // Records are buffered and written this many at a time
+}
+
+bool BinarySnapshot::write(const QString& filename, const std::vector<TaskItem>& tasks, qint64 seq)
+{
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrderMark;
+    header.recordSize = sizeof(Record);
+    header.seq = seq;
+    header.count = tasks.size();
+    header.heapSize = 0;
+    for (const TaskItem& t : tasks) {
+        header.heapSize += t.text.size();
+    }
+
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    bool ok = file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == sizeof(header);
+
+    std::vector<Record> chunk;
+    chunk.reserve(kRecordChunk);
+    quint64 offset = 0;
+    for (size_t i = 0; ok && i < tasks.size(); ++i) {
+        const TaskItem& t = tasks[i];
+        chunk.push_back({ t.id, t.alarmTime, offset, static_cast<quint32>(t.text.size()), t.isCompleted ? kCompletedFlag : 0, t.completedAt });
+        offset += t.text.size();
+
+        if (chunk.size() == kRecordChunk || i + 1 == tasks.size()) {
+            qint64 bytes = static_cast<qint64>(chunk.size() * sizeof(Record));
+            ok = file.write(reinterpret_cast<const char*>(chunk.data()), bytes) == bytes;
+            chunk.clear();
+        }
+    }
+
+    for (size_t i = 0; ok && i < tasks.size(); ++i) {
+        qint64 bytes = tasks[i].text.size() * static_cast<qint64>(sizeof(QChar));
+        ok = file.write(reinterpret_cast<const char*>(tasks[i].text.constData()), bytes) == bytes;
+    }
+
+    if (!ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool BinarySnapshot::open(const QString& filename)
+{
+    m_file.setFileName(filename);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+
+    quint64 size = static_cast<quint64>(m_file.size());
+    if (size < sizeof(Header))
+        return false;
+
+    const uchar* data = m_file.map(0, m_file.size());
+    if (!data)
+        return false;
+
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    bool knownVersion = (header.version == kVersion && header.recordSize == sizeof(Record))
+        || (header.version == 1 && header.recordSize == kVersion1RecordSize);
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || !knownVersion || header.byteOrder != kByteOrderMark)
+        return false;
+
+    // Sizes come from the file, so check them without overflowing
+    quint64 maxCount = (size - sizeof(Header)) / header.recordSize;
+    if (header.count > maxCount)
+        return false;
+    quint64 heapStart = sizeof(Header) + header.count * header.recordSize;
+    if (header.heapSize > (size - heapStart) / sizeof(QChar))
+        return false;
+
+    m_records = data + sizeof(Header);
+    m_heap = reinterpret_cast<const QChar*>(data + heapStart);
+    m_recordSize = header.recordSize;
+    m_count = header.count;
+    m_heapSize = header.heapSize;
+    m_seq = header.seq;
+    return true;
+}
+
+bool BinarySnapshot::taskAt(size_t index, TaskItem& task) const
+{
+    const Record& r = *reinterpret_cast<const Record*>(m_records + index * m_recordSize);
+    if (r.textOffset > m_heapSize || r.textLength > m_heapSize - r.textOffset)
+        return false;
+
+    task = {
+        static_cast<TaskId>(r.id),
+        QString::fromRawData(m_heap + r.textOffset, static_cast<qsizetype>(r.textLength)),
+        (r.flags & kCompletedFlag) != 0,
+        r.alarmTime,
+        m_recordSize >= sizeof(Record) ? r.completedAt : 0
+    };
+    return true;
+}
@@ -8,23 +8,122 @@
 #include <QSettings>
 
 // Windows API for true DWM blur
+#ifdef Q_OS_WIN
 #include <windows.h>
 #include <dwmapi.h>
 #pragma comment(lib, "dwmapi.lib")
+#endif
+
+namespace {
+// Frames per second of the pre-rendered button animation, "animationFps" in the settings
+int animationFps()
+{
+    QSettings settings("Developer", "MiniTasks");
+    return settings.value("animationFps", 20).toInt();
+}
+
+const char* const kNormalSvg = R"V0G0N(
+<svg width="120" height="120" viewBox="0 0 120 120" xmlns="http://www.w3.org/2000/svg">
+  <defs>
+    <style>
+      @keyframes float { 0%, 100% { transform: translateY(0px); } 50% { transform: translateY(-5px); } }
+      @keyframes drawTick { 0% { stroke-dashoffset: 40; opacity: 0; } 10% { opacity: 1; } 100% { stroke-dashoffset: 0; opacity: 1; } }
+      @keyframes pulse { 0%, 100% { filter: drop-shadow(0 0 1px #00f7ff) drop-shadow(0 0 2px #00f7ff); } 50% { filter: drop-shadow(0 0 2px #00f7ff) drop-shadow(0 0 4px #00f7ff); } }
+      .bubble-group { animation: float 4s ease-in-out infinite; transform-origin: center; }
+      .tick-path { stroke-dasharray: 40; stroke-dashoffset: 40; animation: drawTick 1.2s cubic-bezier(0.25, 1, 0.5, 1) forwards 0.3s, pulse 3s ease-in-out infinite 1.5s; }
+    </style>
+    <radialGradient id="bubble-body" cx="50%" cy="50%" r="50%" fx="40%" fy="40%">
+      <stop offset="0%" stop-color="#fff" stop-opacity="0.05"/><stop offset="75%" stop-color="#a3cfff" stop-opacity="0.25"/><stop offset="95%" stop-color="#c98fff" stop-opacity="0.45"/><stop offset="100%" stop-color="#90e0ff" stop-opacity="0.6"/>
+    </radialGradient>
+    <linearGradient id="iridescence" x1="0%" y1="0%" x2="100%" y2="100%">
+      <stop offset="20%" stop-color="#00ffff" stop-opacity="0.5"><animate attributeName="stop-color" values="#00ffff;#ff00ff;#ffff00;#00ffff" dur="5s" repeatCount="indefinite" /></stop>
+      <stop offset="50%" stop-color="#ff00ff" stop-opacity="0.4"><animate attributeName="stop-color" values="#ff00ff;#ffff00;#00ffff;#ff00ff" dur="5s" repeatCount="indefinite" /></stop>
+      <stop offset="80%" stop-color="#ffff00" stop-opacity="0.5"><animate attributeName="stop-color" values="#ffff00;#00ffff;#ff00ff;#ffff00" dur="5s" repeatCount="indefinite" /></stop>
+    </linearGradient>
+    <linearGradient id="sharp-highlight" x1="0%" y1="0%" x2="0%" y2="100%">
+      <stop offset="0%" stop-color="white" stop-opacity="0.95"/><stop offset="100%" stop-color="white" stop-opacity="0"/>
+    </linearGradient>
+  </defs>
+  <g class="bubble-group">
+    <circle cx="60" cy="60" r="30" fill="url(#bubble-body)" stroke="url(#iridescence)" stroke-width="1"/>
+    <path d="M 45 45 Q 60 33 75 45" stroke="url(#sharp-highlight)" stroke-width="2" fill="none" stroke-linecap="round" opacity="0.9" transform="rotate(-15 60 60)"/>
+    <path d="M 69 75 Q 75 72 78 66" stroke="white" stroke-width="1.2" fill="none" stroke-linecap="round" opacity="0.6"/>
+    <path class="tick-path" d="M49.8 60 L57 67.2 L70.2 52.8" stroke="#00f7ff" stroke-width="2" fill="none" stroke-linecap="round" stroke-linejoin="round" />
+  </g>
+</svg>
+)V0G0N";
+
+const char* const kUrgentSvg = R"V0G0N(
+<svg width="120" height="120" viewBox="0 0 120 120" xmlns="http://www.w3.org/2000/svg">
+  <defs>
+    <style>
+      @keyframes pulseUrgent { 0%, 100% { filter: drop-shadow(0 0 4px #4f46e5) drop-shadow(0 0 10px #4f46e5); } 50% { filter: drop-shadow(0 0 12px #818cf8) drop-shadow(0 0 25px #a5b4fc); } }
+      .bubble-group { animation: float 1.5s ease-in-out infinite; transform-origin: center; }
+      @keyframes float { 0%, 100% { transform: translateY(0px); } 50% { transform: translateY(-8px); } }
+      .tick-path { stroke-dasharray: 40; stroke-dashoffset: 0; animation: pulseUrgent 0.6s ease-in-out infinite; }
+    </style>
+    <radialGradient id="bubble-body" cx="50%" cy="50%" r="50%" fx="40%" fy="40%">
+      <stop offset="0%" stop-color="#fff" stop-opacity="0.05"/><stop offset="75%" stop-color="#818cf8" stop-opacity="0.45"/><stop offset="95%" stop-color="#6366f1" stop-opacity="0.65"/><stop offset="100%" stop-color="#4f46e5" stop-opacity="0.8"/>
+    </radialGradient>
+    <linearGradient id="iridescence" x1="0%" y1="0%" x2="100%" y2="100%">
+      <stop offset="20%" stop-color="#4f46e5" stop-opacity="0.7"><animate attributeName="stop-color" values="#4f46e5;#818cf8;#4f46e5" dur="1s" repeatCount="indefinite" /></stop>
+      <stop offset="50%" stop-color="#818cf8" stop-opacity="0.6"><animate attributeName="stop-color" values="#818cf8;#4f46e5;#818cf8" dur="1s" repeatCount="indefinite" /></stop>
+      <stop offset="80%" stop-color="#4f46e5" stop-opacity="0.7"><animate attributeName="stop-color" values="#4f46e5;#818cf8;#4f46e5" dur="1s" repeatCount="indefinite" /></stop>
+    </linearGradient>
+    <linearGradient id="sharp-highlight" x1="0%" y1="0%" x2="0%" y2="100%">
+      <stop offset="0%" stop-color="white" stop-opacity="0.95"/><stop offset="100%" stop-color="white" stop-opacity="0"/>
+    </linearGradient>
+  </defs>
+  <g class="bubble-group">
+    <circle cx="60" cy="60" r="30" fill="url(#bubble-body)" stroke="url(#iridescence)" stroke-width="1"/>
+    <path d="M 45 45 Q 60 33 75 45" stroke="url(#sharp-highlight)" stroke-width="2" fill="none" stroke-linecap="round" opacity="0.9" transform="rotate(-15 60 60)"/>
+    <path class="tick-path" d="M49.8 60 L57 67.2 L70.2 52.8" stroke="#a5b4fc" stroke-width="2" fill="none" stroke-linecap="round" stroke-linejoin="round"/>
+  </g>
+</svg>
+)V0G0N";
+}
 
 FloatingButton::FloatingButton(QWidget *parent)
-    : QWidget(parent)
+    : QWidget(parent),
+      m_normalSprite(kNormalSvg, QSize(60, 60), animationFps()),
+      m_urgentSprite(kUrgentSvg, QSize(60, 60), animationFps())
 {
     setWindowFlags(Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint | Qt::Tool);
     setAttribute(Qt::WA_TranslucentBackground);
     setFixedSize(60, 60); // Updated to 60x60 to match the SVG dimensions better
 
-    m_svgWidget = new QSvgWidget(this);
+    // Rasterize both states up front so an alarm switches the animation instantly
+    m_normalSprite.prepare(devicePixelRatioF());
+    m_urgentSprite.prepare(devicePixelRatioF());
+    m_animationTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_animationTimer, &QTimer::timeout, this, [this]() {
+        m_frame = (m_frame + 1) % currentSprite().frameCount();
+        update();
+    });
     m_isAlarmUrgent = true; // force an evaluation flip on the first call
     updateSvgState(false);
 
-    m_popup = new TaskPopup();
-    m_sidePanel = new SidePanel();
+    // The scheduler wakes up exactly at the nearest deadline instead of polling
+    connect(&m_alarms, &AlarmScheduler::dueChanged, this, &FloatingButton::updateSvgState);
+    m_alarms.reset(m_storage.tasks());
+
+    // Connected ahead of the popup, so the task list always sees an up-to-date due set.
+    // tasks.json loads in the background, alarms are picked up as its chunks arrive.
+    connect(&m_storage, &TaskStorage::taskInserted, this, &FloatingButton::syncAlarm);
+    connect(&m_storage, &TaskStorage::taskChanged, this, &FloatingButton::syncAlarm);
+    connect(&m_storage, &TaskStorage::taskRemoved, this, &FloatingButton::syncAlarm);
+    connect(&m_storage, &TaskStorage::tasksAppended, this, [this](int first, int count) {
+        for (int i = first; i < first + count; ++i) {
+            syncAlarm(m_storage.tasks()[i].id);
+        }
+    });
+    connect(&m_storage, &TaskStorage::reloaded, this, [this]() {
+        m_alarms.reset(m_storage.tasks());
+    });
+    updateSvgState(m_alarms.hasDue());
+
+    m_popup = new TaskPopup(&m_storage, &m_alarms);
+    m_sidePanel = new SidePanel(&m_alarms);
     
     // Connect popup signals to logic
     connect(m_popup, &TaskPopup::taskAdded, this, &FloatingButton::handleTaskAdded);
@@ -43,15 +142,16 @@ FloatingButton::FloatingButton(QWidget *parent)
     });
 
     // Connect SidePanel navigation -> FloatingButton -> TaskPopup
-    connect(m_sidePanel, &SidePanel::scrollTargetRequested, this, [this](int targetIndex) {
+    connect(m_sidePanel, &SidePanel::scrollTargetRequested, this, [this](TaskId targetId) {
         if (m_popup->isVisible() && m_popup) {
-            m_popup->scrollToTask(targetIndex);
+            m_popup->scrollToTask(targetId);
         }
     });
 
     m_popup->winId(); // Ensure window handler is created for blur logic
     m_sidePanel->winId();
     
+#ifdef Q_OS_WIN
     // Apply blur to popup as well
     HWND hwndFallback = (HWND)m_popup->winId();
     if (hwndFallback) {
@@ -70,15 +170,29 @@ FloatingButton::FloatingButton(QWidget *parent)
         bb.hRgnBlur = NULL;
         DwmEnableBlurBehindWindow(hwndSide, &bb);
     }
+#endif
 
     // Load saved position or use default
     QSettings settings("Developer", "MiniTasks");
     QPoint savedPos = settings.value("buttonPosition", QPoint(-1, -1)).toPoint();
+
+    // "snapshotFormat" is "json" or "binary"; unset keeps whichever format was found on disk
+    QString snapshotFormat = settings.value("snapshotFormat").toString();
+    if (snapshotFormat == "binary") {
+        m_storage.setSnapshotFormat(TaskStorage::SnapshotFormat::Binary);
+    } else if (snapshotFormat == "json") {
+        m_storage.setSnapshotFormat(TaskStorage::SnapshotFormat::Json);
+    }
+
+    // Completed tasks move to tasks.archive after "archiveAfterDays" (default 30), 0 keeps them all
+    int archiveDays = settings.value("archiveAfterDays", 30).toInt();
+    m_storage.setArchiveAge(archiveDays * 24LL * 60 * 60 * 1000);
+
+    // Storage changes within "refreshWindowMs" (default 0, one event loop turn) reach the lists as one refresh
+    int refreshWindow = settings.value("refreshWindowMs", 0).toInt();
+    m_popup->setRefreshWindow(refreshWindow);
+    m_sidePanel->setRefreshWindow(refreshWindow);
     
-    m_alarmTimer = new QTimer(this);
-    connect(m_alarmTimer, &QTimer::timeout, this, &FloatingButton::checkAlarms);
-    m_alarmTimer->start(15000); // Check every 15 seconds
-    checkAlarms();
     
     if (savedPos != QPoint(-1, -1)) {
         move(savedPos);
@@ -125,6 +239,16 @@ void FloatingButton::showEvent(QShowEvent *event)
 {
     QWidget::showEvent(event);
     repositionPopup();
+
+    if (currentSprite().frameInterval() > 0) {
+        m_animationTimer.start(currentSprite().frameInterval());
+    }
+}
+
+void FloatingButton::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_animationTimer.stop();
 }
 
 void FloatingButton::mousePressEvent(QMouseEvent *event)
@@ -194,9 +318,7 @@ void FloatingButton::togglePopup()
         m_popup->hide();
         m_sidePanel->hide();
     } else {
-        auto tasks = m_storage.load();
-        m_popup->reloadTasks(tasks);
-        m_sidePanel->reloadSchedule(tasks);
+        // Both lists are kept current incrementally, opening the popup rebuilds nothing
         repositionPopup(); // Guarantee exact position before showing
         m_sidePanel->show(); // Show side panel first so popup takes focus afterwards
         m_popup->show();
@@ -206,69 +328,43 @@ void FloatingButton::togglePopup()
 void FloatingButton::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event);
-    // Left completely blank, as QSvgWidget handles display.
+    // Frames carry their own device pixel ratio, a new screen renders its strip once
+    QPainter painter(this);
+    painter.drawPixmap(0, 0, currentSprite().frame(m_frame, devicePixelRatioF()));
 }
 
 void FloatingButton::handleTaskAdded(const QString& task)
 {
     m_storage.add(task);
-    auto tasks = m_storage.load();
-    m_popup->reloadTasks(tasks);
-    m_sidePanel->reloadSchedule(tasks);
-    checkAlarms();
 }
 
-void FloatingButton::handleTaskDeleted(int index)
+void FloatingButton::handleTaskDeleted(TaskId id)
 {
-    m_storage.remove(index);
-    auto tasks = m_storage.load();
-    m_popup->reloadTasks(tasks);
-    m_sidePanel->reloadSchedule(tasks);
-    checkAlarms();
+    m_storage.remove(id);
 }
 
-void FloatingButton::handleTaskEdited(int index, const QString& newText)
+void FloatingButton::handleTaskEdited(TaskId id, const QString& newText)
 {
-    m_storage.update(index, newText);
-    auto tasks = m_storage.load();
-    m_popup->reloadTasks(tasks);
-    m_sidePanel->reloadSchedule(tasks);
-    checkAlarms();
+    m_storage.update(id, newText);
 }
 
-void FloatingButton::handleTaskDone(int index, bool completed)
+void FloatingButton::handleTaskDone(TaskId id, bool completed)
 {
-    m_storage.setCompleted(index, completed);
-    auto tasks = m_storage.load();
-    m_popup->reloadTasks(tasks);
-    m_sidePanel->reloadSchedule(tasks);
-    checkAlarms();
+    m_storage.setCompleted(id, completed);
 }
 
-void FloatingButton::handleTaskSnoozed(int index)
+void FloatingButton::handleTaskSnoozed(TaskId id)
 {
-    m_storage.snooze(index);
-    auto tasks = m_storage.load();
-    m_popup->reloadTasks(tasks);
-    m_sidePanel->reloadSchedule(tasks);
-    checkAlarms();
+    m_storage.snooze(id);
 }
 
-void FloatingButton::checkAlarms()
+void FloatingButton::syncAlarm(TaskId id)
 {
-    auto tasks = m_storage.load();
-    qint64 now = QDateTime::currentMSecsSinceEpoch();
-    bool hasUrgent = false;
-
-    for (const auto& t : tasks) {
-        if (!t.isCompleted && t.alarmTime > 0 && now >= t.alarmTime) {
-            hasUrgent = true;
-            break;
-        }
-    }
-
-    if (hasUrgent != m_isAlarmUrgent) {
-        updateSvgState(hasUrgent);
+    const TaskItem* task = m_storage.find(id);
+    if (task && !task->isCompleted) {
+        m_alarms.schedule(id, task->alarmTime);
+    } else {
+        m_alarms.cancel(id);
     }
 }
 
@@ -277,68 +373,19 @@ void FloatingButton::updateSvgState(bool urgent)
     if (urgent == m_isAlarmUrgent) return;
     m_isAlarmUrgent = urgent;
 
-    QString normalSvg = R"V0G0N(
-<svg width="120" height="120" viewBox="0 0 120 120" xmlns="http://www.w3.org/2000/svg">
-  <defs>
-    <style>
-      @keyframes float { 0%, 100% { transform: translateY(0px); } 50% { transform: translateY(-5px); } }
-      @keyframes drawTick { 0% { stroke-dashoffset: 40; opacity: 0; } 10% { opacity: 1; } 100% { stroke-dashoffset: 0; opacity: 1; } }
-      @keyframes pulse { 0%, 100% { filter: drop-shadow(0 0 1px #00f7ff) drop-shadow(0 0 2px #00f7ff); } 50% { filter: drop-shadow(0 0 2px #00f7ff) drop-shadow(0 0 4px #00f7ff); } }
-      .bubble-group { animation: float 4s ease-in-out infinite; transform-origin: center; }
-      .tick-path { stroke-dasharray: 40; stroke-dashoffset: 40; animation: drawTick 1.2s cubic-bezier(0.25, 1, 0.5, 1) forwards 0.3s, pulse 3s ease-in-out infinite 1.5s; }
-    </style>
-    <radialGradient id="bubble-body" cx="50%" cy="50%" r="50%" fx="40%" fy="40%">
-      <stop offset="0%" stop-color="#fff" stop-opacity="0.05"/><stop offset="75%" stop-color="#a3cfff" stop-opacity="0.25"/><stop offset="95%" stop-color="#c98fff" stop-opacity="0.45"/><stop offset="100%" stop-color="#90e0ff" stop-opacity="0.6"/>
-    </radialGradient>
-    <linearGradient id="iridescence" x1="0%" y1="0%" x2="100%" y2="100%">
-      <stop offset="20%" stop-color="#00ffff" stop-opacity="0.5"><animate attributeName="stop-color" values="#00ffff;#ff00ff;#ffff00;#00ffff" dur="5s" repeatCount="indefinite" /></stop>
-      <stop offset="50%" stop-color="#ff00ff" stop-opacity="0.4"><animate attributeName="stop-color" values="#ff00ff;#ffff00;#00ffff;#ff00ff" dur="5s" repeatCount="indefinite" /></stop>
-      <stop offset="80%" stop-color="#ffff00" stop-opacity="0.5"><animate attributeName="stop-color" values="#ffff00;#00ffff;#ff00ff;#ffff00" dur="5s" repeatCount="indefinite" /></stop>
-    </linearGradient>
-    <linearGradient id="sharp-highlight" x1="0%" y1="0%" x2="0%" y2="100%">
-      <stop offset="0%" stop-color="white" stop-opacity="0.95"/><stop offset="100%" stop-color="white" stop-opacity="0"/>
-    </linearGradient>
-  </defs>
-  <g class="bubble-group">
-    <circle cx="60" cy="60" r="30" fill="url(#bubble-body)" stroke="url(#iridescence)" stroke-width="1"/>
-    <path d="M 45 45 Q 60 33 75 45" stroke="url(#sharp-highlight)" stroke-width="2" fill="none" stroke-linecap="round" opacity="0.9" transform="rotate(-15 60 60)"/>
-    <path d="M 69 75 Q 75 72 78 66" stroke="white" stroke-width="1.2" fill="none" stroke-linecap="round" opacity="0.6"/>
-    <path class="tick-path" d="M49.8 60 L57 67.2 L70.2 52.8" stroke="#00f7ff" stroke-width="2" fill="none" stroke-linecap="round" stroke-linejoin="round" />
-  </g>
-</svg>
-)V0G0N";
-
-    QString urgentSvg = R"V0G0N(
-<svg width="120" height="120" viewBox="0 0 120 120" xmlns="http://www.w3.org/2000/svg">
-  <defs>
-    <style>
-      @keyframes pulseUrgent { 0%, 100% { filter: drop-shadow(0 0 4px #4f46e5) drop-shadow(0 0 10px #4f46e5); } 50% { filter: drop-shadow(0 0 12px #818cf8) drop-shadow(0 0 25px #a5b4fc); } }
-      .bubble-group { animation: float 1.5s ease-in-out infinite; transform-origin: center; }
-      @keyframes float { 0%, 100% { transform: translateY(0px); } 50% { transform: translateY(-8px); } }
-      .tick-path { stroke-dasharray: 40; stroke-dashoffset: 0; animation: pulseUrgent 0.6s ease-in-out infinite; }
-    </style>
-    <radialGradient id="bubble-body" cx="50%" cy="50%" r="50%" fx="40%" fy="40%">
-      <stop offset="0%" stop-color="#fff" stop-opacity="0.05"/><stop offset="75%" stop-color="#818cf8" stop-opacity="0.45"/><stop offset="95%" stop-color="#6366f1" stop-opacity="0.65"/><stop offset="100%" stop-color="#4f46e5" stop-opacity="0.8"/>
-    </radialGradient>
-    <linearGradient id="iridescence" x1="0%" y1="0%" x2="100%" y2="100%">
-      <stop offset="20%" stop-color="#4f46e5" stop-opacity="0.7"><animate attributeName="stop-color" values="#4f46e5;#818cf8;#4f46e5" dur="1s" repeatCount="indefinite" /></stop>
-      <stop offset="50%" stop-color="#818cf8" stop-opacity="0.6"><animate attributeName="stop-color" values="#818cf8;#4f46e5;#818cf8" dur="1s" repeatCount="indefinite" /></stop>
-      <stop offset="80%" stop-color="#4f46e5" stop-opacity="0.7"><animate attributeName="stop-color" values="#4f46e5;#818cf8;#4f46e5" dur="1s" repeatCount="indefinite" /></stop>
-    </linearGradient>
-    <linearGradient id="sharp-highlight" x1="0%" y1="0%" x2="0%" y2="100%">
-      <stop offset="0%" stop-color="white" stop-opacity="0.95"/><stop offset="100%" stop-color="white" stop-opacity="0"/>
-    </linearGradient>
-  </defs>
-  <g class="bubble-group">
-    <circle cx="60" cy="60" r="30" fill="url(#bubble-body)" stroke="url(#iridescence)" stroke-width="1"/>
-    <path d="M 45 45 Q 60 33 75 45" stroke="url(#sharp-highlight)" stroke-width="2" fill="none" stroke-linecap="round" opacity="0.9" transform="rotate(-15 60 60)"/>
-    <path class="tick-path" d="M49.8 60 L57 67.2 L70.2 52.8" stroke="#a5b4fc" stroke-width="2" fill="none" stroke-linecap="round" stroke-linejoin="round"/>
-  </g>
-</svg>
-)V0G0N";
+    // Both strips are already rendered, switching only restarts playback
+    m_frame = 0;
+    SvgSprite& sprite = currentSprite();
+    sprite.prepare(devicePixelRatioF());
+    if (sprite.frameInterval() > 0 && isVisible()) {
+        m_animationTimer.start(sprite.frameInterval());
+    } else {
+        m_animationTimer.stop();
+    }
+    update();
+}
 
-    m_svgWidget->load(QByteArray(urgent ? urgentSvg.toUtf8() : normalSvg.toUtf8()));
-    m_svgWidget->setFixedSize(60, 60);
-    m_svgWidget->setAttribute(Qt::WA_TransparentForMouseEvents);
-    m_svgWidget->setStyleSheet("background: transparent; border: none;");
+SvgSprite& FloatingButton::currentSprite()
+{
+    return m_isAlarmUrgent ? m_urgentSprite : m_normalSprite;
 }
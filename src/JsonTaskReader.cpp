@@ -0,0 +1,167 @@
+#include "JsonTaskReader.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+
+namespace {
+const qint64 kBlockSize = 64 * 1024;
+const size_t kMinParallelObjects = 1024; // Smaller chunks aren't worth the thread hand-off
+}
+
+JsonTaskReader::JsonTaskReader(const QString& filename)
+    : m_file(filename)
+{
+}
+
+bool JsonTaskReader::open()
+{
+    m_atEnd = !m_file.open(QIODevice::ReadOnly);
+    return !m_atEnd;
+}
+
+void JsonTaskReader::readChunk(std::vector<TaskItem>& out, size_t maxTasks)
+{
+    m_raw.clear();
+    m_objects.clear();
+
+    while (!m_atEnd && m_objects.size() < maxTasks) {
+        if (scan(maxTasks))
+            continue;
+
+        // Block used up: keep the unfinished task object, then read on
+        if (m_objectStart >= 0) {
+            m_raw.append(m_block.constData() + m_objectStart, m_block.size() - m_objectStart);
+            m_objectStart = 0;
+        }
+        m_block = m_file.read(kBlockSize);
+        m_pos = 0;
+        if (m_block.isEmpty()) {
+            m_atEnd = true;
+            m_file.close();
+        }
+    }
+
+    parseObjects(out);
+}
+
+void JsonTaskReader::parseObjects(std::vector<TaskItem>& out) const
+{
+    size_t count = m_objects.size();
+    size_t first = out.size();
+    out.resize(first + count);
+    std::vector<char> valid(count, 0);
+
+    auto parseRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const auto& [offset, length] = m_objects[i];
+            QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromRawData(m_raw.constData() + offset, length));
+            if (doc.isObject()) {
+                out[first + i] = taskFromJson(doc.object());
+                valid[i] = 1;
+            }
+        }
+    };
+
+    int threads = QThreadPool::globalInstance()->maxThreadCount();
+    if (!m_parallel || threads < 2 || count < kMinParallelObjects) {
+        parseRange(0, count);
+    } else {
+        // One contiguous slice per thread, each writes its own part of out
+        std::vector<std::pair<size_t, size_t>> slices;
+        size_t step = (count + threads - 1) / threads;
+        for (size_t begin = 0; begin < count; begin += step) {
+            slices.push_back({ begin, std::min(begin + step, count) });
+        }
+        QtConcurrent::blockingMap(slices, [&parseRange](const std::pair<size_t, size_t>& slice) {
+            parseRange(slice.first, slice.second);
+        });
+    }
+
+    // Objects that failed to parse are dropped, as the sequential reader did
+    if (std::find(valid.begin(), valid.end(), 0) != valid.end()) {
+        size_t kept = first;
+        for (size_t i = 0; i < count; ++i) {
+            if (!valid[i]) continue;
+            if (kept != first + i) out[kept] = std::move(out[first + i]);
+            kept++;
+        }
+        out.resize(kept);
+    }
+}
+
+bool JsonTaskReader::scan(size_t target)
+{
+    const char* data = m_block.constData();
+    const int size = m_block.size();
+
+    while (m_pos < size) {
+        char c = data[m_pos++];
+
+        if (m_inString) {
+            if (m_escape) {
+                m_escape = false;
+            } else if (c == '\\') {
+                m_escape = true;
+            } else if (c == '"') {
+                m_inString = false;
+                continue;
+            }
+            if (m_capturingKey) m_string.append(c);
+            continue;
+        }
+
+        switch (c) {
+        case '"':
+            m_inString = true;
+            m_capturingKey = m_rootIsObject && m_depth == 1;
+            if (m_capturingKey) m_string.clear();
+            break;
+        case '{':
+        case '[':
+            if (m_depth == 0) {
+                m_rootIsObject = c == '{';
+                if (!m_rootIsObject) m_taskDepth = 1;
+            } else if (m_depth == 1 && m_rootIsObject && c == '[' && m_key == "tasks") {
+                m_taskDepth = 2;
+            } else if (c == '{' && m_depth == m_taskDepth) {
+                m_objectStart = m_pos - 1;
+                m_rawStart = m_raw.size();
+            }
+            m_depth++;
+            break;
+        case '}':
+        case ']':
+            m_depth--;
+            if (m_depth == 0 && m_readingSeq) {
+                m_seq = static_cast<qint64>(m_number.trimmed().toDouble());
+                m_readingSeq = false;
+            }
+            if (c == '}' && m_depth == m_taskDepth && m_objectStart >= 0) {
+                m_raw.append(data + m_objectStart, m_pos - m_objectStart);
+                m_objects.push_back({ m_rawStart, m_raw.size() - m_rawStart });
+                m_objectStart = -1;
+                if (m_objects.size() >= target) return true;
+            }
+            break;
+        case ':':
+            if (m_rootIsObject && m_depth == 1) {
+                m_key = m_string;
+                m_readingSeq = m_key == "seq";
+                m_number.clear();
+            }
+            break;
+        case ',':
+            if (m_depth == 1 && m_readingSeq) {
+                m_seq = static_cast<qint64>(m_number.trimmed().toDouble());
+                m_readingSeq = false;
+            }
+            break;
+        default:
+            if (m_readingSeq && m_depth == 1) m_number.append(c);
+            break;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,43 @@
+#include "RefreshCoalescer.h"
+
+RefreshCoalescer::RefreshCoalescer(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(0);
+    connect(&m_timer, &QTimer::timeout, this, &RefreshCoalescer::flush);
+}
+
+void RefreshCoalescer::request()
+{
+    ++m_requests;
+    if (m_pending) return;
+
+    // The window starts at the first request, so a steady stream still refreshes every window
+    m_pending = true;
+    m_timer.start();
+}
+
+void RefreshCoalescer::flush()
+{
+    if (!m_pending) return;
+
+    m_timer.stop();
+    m_pending = false;
+    ++m_refreshes;
+    emit refresh();
+}
+
+void RefreshCoalescer::cancel()
+{
+    if (!m_pending) return;
+
+    // The requests were answered by the rebuild, so they count as coalesced
+    m_timer.stop();
+    m_pending = false;
+}
+
+void RefreshCoalescer::setWindow(int ms)
+{
+    m_timer.setInterval(qMax(0, ms));
+}
@@ -2,11 +2,15 @@
 #include <QPainter>
 #include <QStyleOption>
 #include <QDateTime>
-#include <algorithm>
+#include <QSettings>
 #include "AnalogClock.h"
 
-SidePanel::SidePanel(QWidget *parent)
-    : QWidget(parent)
+namespace {
+const size_t kMaxRows = 50; // Well past what fits above the clock
+}
+
+SidePanel::SidePanel(const AlarmScheduler* alarms, QWidget *parent)
+    : QWidget(parent), m_alarms(alarms)
 {
     // Tool ensures it floats over other windows. 
     // DoesNotAcceptFocus ensures clicking it or showing it doesn't steal focus from TaskPopup (which would auto-close TaskPopup).
@@ -56,45 +60,42 @@ SidePanel::SidePanel(QWidget *parent)
     layout->addWidget(m_scheduleList, 1);
 
     auto* clock = new AnalogClock(this);
+    clock->setShowSeconds(QSettings("Developer", "MiniTasks").value("clockShowSeconds", true).toBool());
     layout->addWidget(clock, 0, Qt::AlignHCenter | Qt::AlignBottom);
 
     connect(m_scheduleList, &QListWidget::itemClicked, this, [this](QListWidgetItem* item) {
         bool ok;
-        int targetIndex = item->data(Qt::UserRole).toInt(&ok);
+        TaskId targetId = item->data(Qt::UserRole).toULongLong(&ok);
         if (ok) {
-            emit scrollTargetRequested(targetIndex);
+            emit scrollTargetRequested(targetId);
         }
     });
+
+    connect(m_alarms, &AlarmScheduler::scheduleChanged, &m_refresh, &RefreshCoalescer::request);
+    connect(&m_refresh, &RefreshCoalescer::refresh, this, &SidePanel::reloadSchedule);
+    reloadSchedule();
 }
 
-void SidePanel::reloadSchedule(const std::vector<TaskItem>& tasks)
+void SidePanel::reloadSchedule()
 {
-    m_scheduleList->clear();
-    
-    // Sort logic requires capturing original indices, so we map them out into pairs
-    std::vector<std::pair<int, TaskItem>> upcoming;
-    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    m_refresh.cancel();
+    if (!m_alarms) return;
 
-    for (size_t i = 0; i < tasks.size(); ++i) {
-        const auto& t = tasks[i];
-        if (!t.isCompleted && t.alarmTime > 0 && t.alarmTime >= now) {
-            upcoming.push_back({static_cast<int>(i), t});
+    // Only the first rows of the index are read, and existing items are reused in place
+    std::vector<AlarmScheduler::Entry> entries = m_alarms->upcoming(kMaxRows);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const auto& [alarmTime, id] = entries[i];
+        QListWidgetItem* item = m_scheduleList->item(static_cast<int>(i));
+        if (!item) {
+            item = new QListWidgetItem();
+            item->setTextAlignment(Qt::AlignCenter);
+            m_scheduleList->addItem(item);
         }
+        item->setText(QDateTime::fromMSecsSinceEpoch(alarmTime).toString("HH:mm"));
+        item->setData(Qt::UserRole, QVariant::fromValue(id)); // Store the task id natively
     }
-
-    // Sort ascending by alarm time (nearest future first)
-    std::sort(upcoming.begin(), upcoming.end(), [](const auto& a, const auto& b) {
-        return a.second.alarmTime < b.second.alarmTime;
-    });
-
-    for (const auto& pair : upcoming) {
-        QDateTime dt = QDateTime::fromMSecsSinceEpoch(pair.second.alarmTime);
-        QString timeStr = dt.toString("HH:mm");
-        
-        auto* item = new QListWidgetItem(timeStr, m_scheduleList);
-        item->setTextAlignment(Qt::AlignCenter);
-        item->setData(Qt::UserRole, pair.first); // Store the original tasks.json index natively
-        m_scheduleList->addItem(item);
+    while (m_scheduleList->count() > static_cast<int>(entries.size())) {
+        delete m_scheduleList->takeItem(m_scheduleList->count() - 1);
     }
 }
 
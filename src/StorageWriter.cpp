@@ -0,0 +1,283 @@
+#include "StorageWriter.h"
+#include "BinarySnapshot.h"
+#include <QFile>
+#include <QTimer>
+#include <QMutexLocker>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+// QFile::flush only hands data to the OS, this waits for the disk
+bool syncToDisk(QFile& file)
+{
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+}
+
+StorageWriter::StorageWriter(const QStringList& snapshotFilenames, const QString& journalFilename)
+    : m_snapshotFilenames(snapshotFilenames), m_journalFilename(journalFilename)
+{
+    m_thread.setObjectName("StorageWriter");
+    moveToThread(&m_thread);
+    m_thread.start();
+}
+
+StorageWriter::~StorageWriter()
+{
+    waitForIdle();
+    m_thread.quit();
+    m_thread.wait();
+
+    // A write that kept failing gets one last try before it is lost
+    if (m_failedSnapshot) {
+        writeSnapshotFile(*m_failedSnapshot);
+    }
+    if (!m_unwritten.isEmpty()) {
+        writeJournal(QByteArray());
+    }
+    syncJournal();
+    closeJournal();
+}
+
+void StorageWriter::appendJournal(const QByteArray& records, qint64 lastSeq)
+{
+    if (records.isEmpty()) return;
+    enqueue({ Request::Append, lastSeq, records, {} });
+}
+
+void StorageWriter::writeSnapshot(std::vector<TaskItem> tasks, qint64 seq, bool journaled,
+                                  TaskStorage::SnapshotFormat format, const QString& filename)
+{
+    enqueue({ Request::Snapshot, seq, QByteArray(), std::move(tasks), journaled, format, filename });
+}
+
+bool StorageWriter::writeSnapshotFile(const Request& request)
+{
+    if (request.format == TaskStorage::SnapshotFormat::Binary) {
+        return BinarySnapshot::write(request.filename, request.tasks, request.seq);
+    }
+    // Always seq-stamped: a journal that couldn't be removed is then skipped up to here on load
+    return saveInternal(request.filename, request.tasks, request.seq);
+}
+
+void StorageWriter::appendArchive(const QByteArray& records, const QString& filename)
+{
+    enqueue({ Request::Archive, 0, records, {}, false, TaskStorage::SnapshotFormat::Json, filename });
+}
+
+bool StorageWriter::writeArchive(const Request& request)
+{
+    // Rare and the caller waits for it, so it is synced right away rather than group-committed.
+    // A torn last line is skipped when the archive is read.
+    QFile file(request.filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered))
+        return false;
+    return file.write(request.records) == request.records.size() && syncToDisk(file);
+}
+
+void StorageWriter::syncNow()
+{
+    enqueue({ Request::Sync, 0, QByteArray(), {} });
+}
+
+void StorageWriter::enqueue(Request request)
+{
+    QMutexLocker locker(&m_mutex);
+    m_queue.push_back(std::move(request));
+    if (!m_drainScheduled) {
+        m_drainScheduled = true;
+        QMetaObject::invokeMethod(this, &StorageWriter::drain, Qt::QueuedConnection);
+    }
+}
+
+void StorageWriter::waitForIdle()
+{
+    QMutexLocker locker(&m_mutex);
+    while (!m_queue.empty() || m_busy) {
+        m_idle.wait(&m_mutex);
+    }
+}
+
+bool StorageWriter::writeJournal(const QByteArray& data)
+{
+    QByteArray batch = m_unwritten + data;
+    if (batch.isEmpty()) return true;
+
+    if (!m_journal) {
+        // Unbuffered, so write() reports what actually reached the OS
+        m_journal = std::make_unique<QFile>(m_journalFilename);
+        if (!m_journal->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered)) {
+            m_journal.reset();
+            m_unwritten = batch;
+            return false;
+        }
+    }
+
+    // A partial write leaves a torn line behind; appending the rest of the batch on
+    // retry completes it, so only the unwritten tail is kept
+    qint64 written = m_journal->write(batch);
+    if (written != batch.size()) {
+        m_unwritten = batch.mid(qMax<qint64>(written, 0));
+        closeJournal();
+        return false;
+    }
+
+    m_unwritten.clear();
+    return true;
+}
+
+void StorageWriter::scheduleSync()
+{
+    int window = m_groupCommitMs;
+    if (window <= 0) {
+        syncJournal();
+    } else if (!m_syncScheduled) {
+        m_syncScheduled = true;
+        QTimer::singleShot(window, this, &StorageWriter::syncJournal);
+    }
+}
+
+void StorageWriter::syncJournal()
+{
+    m_syncScheduled = false;
+    if (!m_journal || m_unsyncedSeq == 0) return;
+
+    if (syncToDisk(*m_journal)) {
+        emit persisted(m_unsyncedSeq);
+        m_unsyncedSeq = 0;
+    } else if (!m_syncScheduled) {
+        // Try again later, even with group commit turned off
+        m_syncScheduled = true;
+        QTimer::singleShot(qMax(int(m_groupCommitMs), 100), this, &StorageWriter::syncJournal);
+    }
+}
+
+void StorageWriter::closeJournal()
+{
+    if (!m_journal) return;
+    m_journal->close();
+    m_journal.reset();
+}
+
+void StorageWriter::drain()
+{
+    std::vector<Request> batch;
+    {
+        QMutexLocker locker(&m_mutex);
+        batch.swap(m_queue);
+        m_drainScheduled = false;
+        m_busy = true;
+    }
+
+    // A failed plain snapshot is retried unless the batch brings a newer one
+    if (m_failedSnapshot) {
+        batch.insert(batch.begin(), std::move(*m_failedSnapshot));
+        m_failedSnapshot.reset();
+    }
+
+    // Only the newest snapshot in the batch needs writing, it contains every older one
+    size_t lastSnapshot = batch.size();
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (batch[i].type == Request::Snapshot) lastSnapshot = i;
+    }
+
+    QByteArray appends;
+    qint64 appendSeq = 0;
+    bool failed = false;
+
+    auto writeAppends = [&]() {
+        if (appends.isEmpty() && m_unwritten.isEmpty()) return;
+        if (writeJournal(appends)) {
+            m_unsyncedSeq = qMax(m_unsyncedSeq, qMax(appendSeq, m_unwrittenSeq));
+            m_unwrittenSeq = 0;
+            scheduleSync();
+        } else {
+            m_unwrittenSeq = qMax(appendSeq, m_unwrittenSeq);
+            failed = true;
+        }
+        appends.clear();
+    };
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        Request& request = batch[i];
+        if (request.type == Request::Append) {
+            // Consecutive appends are coalesced into a single write
+            appends.append(request.records);
+            appendSeq = request.seq;
+            continue;
+        }
+
+        if (request.type == Request::Sync) {
+            writeAppends();
+            syncJournal();
+            continue;
+        }
+
+        if (request.type == Request::Archive) {
+            // Not retried here: the owner only drops archived tasks after a success
+            emit archiveFinished(writeArchive(request));
+            continue;
+        }
+
+        if (i != lastSnapshot) {
+            if (request.journaled) emit compactionFinished(false); // Superseded
+            continue;
+        }
+
+        writeAppends();
+        bool journaled = request.journaled;
+        bool ok = writeSnapshotFile(request);
+        if (ok) {
+            // Older snapshots in other formats or slots are stale now. Removing a mapped one
+            // fails on Windows, the loader then still picks the newest file.
+            for (const QString& other : m_snapshotFilenames) {
+                if (other != request.filename) QFile::remove(other);
+            }
+
+            // Every journal record up to this snapshot is folded in, including any that failed
+            // to append or haven't been synced yet
+            closeJournal();
+            if (!QFile::exists(m_journalFilename) || QFile::remove(m_journalFilename)) {
+                m_unwritten.clear();
+                m_unwrittenSeq = 0;
+                m_unsyncedSeq = 0;
+                failed = false;
+            } else {
+                // The journal stays (locked on Windows, say), so a torn line in it still has to be
+                // completed before anything else is appended. Its records are all folded in.
+                failed = !m_unwritten.isEmpty();
+            }
+            emit persisted(request.seq);
+        } else if (!journaled) {
+            // A failed compaction leaves the journal complete and the owner retries it later,
+            // but a plain snapshot is the only copy of its state
+            m_failedSnapshot = std::move(request);
+            failed = true;
+        }
+        if (journaled) emit compactionFinished(ok);
+    }
+    writeAppends();
+
+    // Nothing else may come along to retry a failed write, so schedule it
+    if (failed && !m_retryScheduled) {
+        m_retryScheduled = true;
+        QTimer::singleShot(1000, this, [this]() {
+            m_retryScheduled = false;
+            enqueue({ Request::Append, m_unwrittenSeq, QByteArray(), {} });
+        });
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_busy = false;
+    if (m_queue.empty()) {
+        m_idle.wakeAll();
+    }
+}
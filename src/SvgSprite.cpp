@@ -0,0 +1,55 @@
+#include "SvgSprite.h"
+#include <QPainter>
+#include <algorithm>
+
+namespace {
+// QSvgRenderer seeks in whole percents of the animation, more frames would only repeat
+const int kMaxFrames = 100;
+}
+
+SvgSprite::SvgSprite(const QByteArray& svg, const QSize& size, int framesPerSecond)
+    : m_size(size)
+{
+    m_renderer.load(svg);
+
+    if (m_renderer.animated() && framesPerSecond > 0) {
+        m_durationMs = m_renderer.animationDuration();
+        m_frameCount = std::clamp(m_durationMs * framesPerSecond / 1000, 1, kMaxFrames);
+    }
+}
+
+int SvgSprite::frameInterval() const
+{
+    return m_frameCount > 1 ? std::max(1, m_durationMs / m_frameCount) : 0;
+}
+
+void SvgSprite::prepare(qreal dpr)
+{
+    if (m_strips.count(dpr)) return;
+
+    std::vector<QPixmap>& strip = m_strips[dpr];
+    strip.reserve(m_frameCount);
+    for (int i = 0; i < m_frameCount; ++i) {
+        if (m_frameCount > 1) {
+            m_renderer.setCurrentFrame(i * 100 / m_frameCount);
+        }
+
+        QPixmap pixmap(m_size * dpr);
+        pixmap.setDevicePixelRatio(dpr);
+        pixmap.fill(Qt::transparent);
+
+        QPainter painter(&pixmap);
+        painter.setRenderHint(QPainter::Antialiasing);
+        m_renderer.render(&painter, QRectF(QPointF(0, 0), m_size));
+        painter.end();
+
+        strip.push_back(pixmap);
+    }
+}
+
+const QPixmap& SvgSprite::frame(int index, qreal dpr)
+{
+    prepare(dpr);
+    const std::vector<QPixmap>& strip = m_strips[dpr];
+    return strip[index % strip.size()];
+}
@@ -0,0 +1,379 @@
+#include "TaskItemDelegate.h"
+#include "TaskListModel.h"
+#include <QPainter>
+#include <QMouseEvent>
+#include <QFontMetrics>
+#include <QTextLayout>
+#include <algorithm>
+
+namespace {
+// Row geometry: 2px 4px card margin that grows to 0px 2px on hover,
+// 8px 4px content margins and 24px action buttons with 4px spacing.
+const int kButtonSize = 24;
+const int kButtonSpacing = 4;
+const int kTextWidth = 188;       // Wrap width for plain rows
+const int kUrgentTextWidth = 160; // Urgent rows make room for the extra snooze button
+const int kMinCachedLayouts = 20000; // Per wrap width, see textLayout
+
+QColor rgba(int r, int g, int b, qreal a)
+{
+    QColor c(r, g, b);
+    c.setAlphaF(a);
+    return c;
+}
+
+enum RowState { NormalRow, UrgentRow, CompletedRow, RowStateCount };
+
+struct RowStyle {
+    QColor background;
+    QColor border;
+    QColor text;
+};
+
+// Glassy row looks, built once and picked by [state][hovered] while painting
+const RowStyle& rowStyle(RowState state, bool hovered)
+{
+    static const RowStyle styles[RowStateCount][2] = {
+        { { rgba(255, 255, 255, 0.05), rgba(255, 255, 255, 0.72), QColor(Qt::white) },
+          { rgba(255, 255, 255, 0.15), rgba(255, 255, 255, 0.82), QColor(Qt::white) } },
+        { { rgba(79, 70, 229, 0.15), rgba(129, 140, 248, 0.9), QColor(Qt::white) },
+          { rgba(79, 70, 229, 0.25), rgba(165, 180, 252, 1.0), QColor(Qt::white) } },
+        { { rgba(255, 255, 255, 0.02), rgba(255, 255, 255, 0.3), rgba(255, 255, 255, 0.4) },
+          { rgba(255, 255, 255, 0.05), rgba(255, 255, 255, 0.4), rgba(255, 255, 255, 0.4) } },
+    };
+    return styles[state][hovered ? 1 : 0];
+}
+
+RowState rowState(bool isCompleted, bool isUrgent)
+{
+    return isCompleted ? CompletedRow : (isUrgent ? UrgentRow : NormalRow);
+}
+}
+
+TaskItemDelegate::TaskItemDelegate(QAbstractItemView *view)
+    : QStyledItemDelegate(view), m_view(view)
+{
+    m_view->viewport()->setMouseTracking(true);
+    m_view->viewport()->installEventFilter(this);
+}
+
+QString TaskItemDelegate::displayText(const QString& text)
+{
+    // Allow up to roughly 3 lines of text (~90 characters) before truncating
+    if (text.length() > 90) {
+        return text.left(86) + "...";
+    }
+    return text;
+}
+
+QRect TaskItemDelegate::cardRect(const QRect& rowRect, bool hovered)
+{
+    return hovered ? rowRect.adjusted(2, 0, -2, 0) : rowRect.adjusted(4, 2, -4, -2);
+}
+
+QRect TaskItemDelegate::buttonRect(const QRect& rowRect, Action action)
+{
+    // Buttons are anchored to the resting card so they don't move under the cursor on hover
+    QRect content = cardRect(rowRect, false).adjusted(8, 4, -8, -4);
+    int slot = 0; // Counted from the right edge
+    switch (action) {
+    case Action::Delete: slot = 0; break;
+    case Action::Done: slot = 1; break;
+    case Action::Snooze: slot = 2; break;
+    case Action::None: return QRect();
+    }
+    int x = content.right() + 1 - (slot + 1) * kButtonSize - slot * kButtonSpacing;
+    return QRect(x, content.top() + 4, kButtonSize, kButtonSize);
+}
+
+TaskItemDelegate::Action TaskItemDelegate::actionAt(const QRect& rowRect, const QPoint& pos, bool isUrgent) const
+{
+    if (buttonRect(rowRect, Action::Delete).contains(pos)) return Action::Delete;
+    if (buttonRect(rowRect, Action::Done).contains(pos)) return Action::Done;
+    if (isUrgent && buttonRect(rowRect, Action::Snooze).contains(pos)) return Action::Snooze;
+    return Action::None;
+}
+
+bool TaskItemDelegate::isHovered(const QRect& rowRect) const
+{
+    return rowRect.contains(m_hoverPos);
+}
+
+void TaskItemDelegate::updateRow(const QModelIndex& index)
+{
+    if (index.isValid()) {
+        m_view->viewport()->update(m_view->visualRect(index));
+    }
+}
+
+void TaskItemDelegate::setFlashedId(TaskId id)
+{
+    m_flashedId = id;
+    m_view->viewport()->update();
+}
+
+void TaskItemDelegate::setHighlight(const QString& text)
+{
+    m_highlight = text;
+    m_view->viewport()->update();
+}
+
+void TaskItemDelegate::setReadOnly(bool readOnly)
+{
+    m_readOnly = readOnly;
+    m_view->viewport()->update();
+}
+
+void TaskItemDelegate::remeasure(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+    if (topLeft.model() != m_view->model()) return;
+
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        QModelIndex index = topLeft.sibling(row, 0);
+        QRect rect = m_view->visualRect(index);
+        if (!rect.isValid()) continue; // Not laid out yet, it gets measured when it is
+
+        bool isUrgent = index.data(TaskListModel::UrgentRole).toBool();
+        if (textLayout(index.data(Qt::DisplayRole).toString(), isUrgent, m_view->font()).rowHeight != rect.height()) {
+            emit sizeHintChanged(index);
+        }
+    }
+}
+
+void TaskItemDelegate::drawHighlightedText(QPainter *painter, const QRect& rect, const QString& text, const QFont& font) const
+{
+    // Same wrapping as drawText, laid out by hand so the matches can get a background
+    QTextLayout layout(text, font);
+    QTextOption option(Qt::AlignLeft);
+    option.setWrapMode(QTextOption::WordWrap);
+    layout.setTextOption(option);
+
+    QTextCharFormat match;
+    match.setBackground(rgba(250, 204, 21, 0.45));
+    QList<QTextLayout::FormatRange> ranges;
+    for (qsizetype at = text.indexOf(m_highlight, 0, Qt::CaseInsensitive); at >= 0;
+         at = text.indexOf(m_highlight, at + m_highlight.size(), Qt::CaseInsensitive)) {
+        ranges.append({ static_cast<int>(at), static_cast<int>(m_highlight.size()), match });
+    }
+    layout.setFormats(ranges);
+
+    qreal height = 0;
+    layout.beginLayout();
+    for (QTextLine line = layout.createLine(); line.isValid(); line = layout.createLine()) {
+        line.setLineWidth(rect.width());
+        line.setPosition(QPointF(0, height));
+        height += line.height();
+    }
+    layout.endLayout();
+
+    painter->save();
+    painter->setClipRect(rect);
+    layout.draw(painter, QPointF(rect.left(), rect.top() + (rect.height() - height) / 2));
+    painter->restore();
+}
+
+const TaskItemDelegate::Fonts& TaskItemDelegate::fonts(const QFont& viewFont) const
+{
+    int dpi = m_view->viewport()->logicalDpiY();
+    if (m_fontsValid && viewFont == m_viewFont && dpi == m_layoutDpi) return m_fonts;
+    m_viewFont = viewFont;
+    m_layoutDpi = dpi;
+    m_fontsValid = true;
+
+    // Every measured height depends on the font and DPI
+    m_layouts[0].clear();
+    m_layouts[1].clear();
+
+    QFont text = viewFont;
+    text.setPixelSize(14);
+    m_fonts.text[NormalRow] = text;
+    m_fonts.text[UrgentRow] = text;
+    m_fonts.text[UrgentRow].setBold(true);
+    m_fonts.text[CompletedRow] = text;
+    m_fonts.text[CompletedRow].setStrikeOut(true);
+
+    QFont glyph = viewFont;
+    glyph.setBold(true);
+    glyph.setPixelSize(14);
+    m_fonts.snoozeGlyph = glyph;
+    glyph.setPixelSize(16);
+    m_fonts.glyph = glyph;
+    return m_fonts;
+}
+
+const TaskItemDelegate::TextLayout& TaskItemDelegate::textLayout(const QString& text, bool isUrgent, const QFont& viewFont) const
+{
+    const Fonts& rowFonts = fonts(viewFont);
+    QHash<QString, TextLayout>& layouts = m_layouts[isUrgent ? 1 : 0];
+
+    auto it = layouts.constFind(text);
+    if (it != layouts.constEnd()) return *it;
+
+    // A relayout measures every row, so the cache holds a whole pass of texts plus as many
+    // again for edited ones; old texts are only dropped wholesale past that
+    int rows = m_view->model() ? m_view->model()->rowCount() : 0;
+    if (layouts.size() >= std::max(kMinCachedLayouts, 2 * rows)) {
+        layouts.clear();
+    }
+
+    TextLayout layout;
+    layout.displayText = displayText(text);
+
+    // Physically simulate word-wrapping across the label bounds
+    QFontMetrics fm(rowFonts.text[NormalRow]);
+    int width = isUrgent ? kUrgentTextWidth : kTextWidth;
+    int textH = fm.boundingRect(0, 0, width, 0, Qt::TextWordWrap, layout.displayText).height();
+
+    layout.rowHeight = 38; // 1 line default
+    if (textH > 40) {
+        layout.rowHeight = 84; // 3+ lines mapped
+    } else if (textH > 20) {
+        layout.rowHeight = 60; // 2 lines mapped
+    }
+    return *layouts.insert(text, layout);
+}
+
+void TaskItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    bool isCompleted = index.data(TaskListModel::CompletedRole).toBool();
+    bool isUrgent = index.data(TaskListModel::UrgentRole).toBool();
+    TaskId id = index.data(TaskListModel::IdRole).value<TaskId>();
+    bool hovered = isHovered(option.rect);
+
+    RowState state = rowState(isCompleted, isUrgent);
+    const RowStyle& style = rowStyle(state, hovered);
+    const Fonts& rowFonts = fonts(option.font);
+
+    QColor border = style.border;
+    int borderWidth = 1;
+    if (id == m_flashedId) {
+        border = QColor(135, 206, 235); // SkyBlue navigation flash
+        borderWidth = 2;
+    }
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    QRectF card = QRectF(cardRect(option.rect, hovered)).adjusted(0.5, 0.5, -0.5, -0.5);
+    painter->setPen(QPen(border, borderWidth));
+    painter->setBrush(style.background);
+    painter->drawRoundedRect(card, 8, 8);
+
+    // Text, inset by the card content margins and the label's 4px padding
+    painter->setFont(rowFonts.text[state]);
+    painter->setPen(style.text);
+
+    QRect content = cardRect(option.rect, false).adjusted(8, 4, -8, -4);
+    QRect textRect(content.left() + 4, content.top() + 4, isUrgent ? kUrgentTextWidth : kTextWidth, content.height() - 8);
+    const TextLayout& layout = textLayout(index.data(Qt::DisplayRole).toString(), isUrgent, option.font);
+    if (!m_highlight.isEmpty() && layout.displayText.contains(m_highlight, Qt::CaseInsensitive)) {
+        drawHighlightedText(painter, textRect, layout.displayText, rowFonts.text[state]);
+    } else {
+        painter->drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextWordWrap, layout.displayText);
+    }
+
+    if (hovered && !m_readOnly) {
+        Action hot = actionAt(option.rect, m_hoverPos, isUrgent);
+
+        auto drawButton = [&](Action action, const QString& glyph, const QFont& font, const QColor& hotColor) {
+            static const QColor idle = rgba(255, 255, 255, 0.6);
+            painter->setFont(font);
+            painter->setPen(hot == action ? hotColor : idle);
+            painter->drawText(buttonRect(option.rect, action), Qt::AlignCenter, glyph);
+        };
+
+        if (isUrgent) {
+            drawButton(Action::Snooze, "zZ", rowFonts.snoozeGlyph, QColor(165, 180, 252));
+        }
+        drawButton(Action::Done, QString::fromUtf8("✓"), rowFonts.glyph, QColor(100, 255, 100));
+        drawButton(Action::Delete, QString::fromUtf8("✕"), rowFonts.glyph, QColor(255, 100, 100));
+    }
+
+    painter->restore();
+}
+
+QSize TaskItemDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    // Unchanged rows are measured once, see textLayout
+    bool isUrgent = index.data(TaskListModel::UrgentRole).toBool();
+    return QSize(0, textLayout(index.data(Qt::DisplayRole).toString(), isUrgent, option.font).rowHeight);
+}
+
+bool TaskItemDelegate::editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem& option, const QModelIndex& index)
+{
+    Q_UNUSED(model);
+    if (m_readOnly)
+        return false;
+    if (event->type() != QEvent::MouseButtonPress && event->type() != QEvent::MouseButtonRelease)
+        return false;
+
+    auto* mouseEvent = static_cast<QMouseEvent*>(event);
+    if (mouseEvent->button() != Qt::LeftButton)
+        return false;
+
+    TaskId id = index.data(TaskListModel::IdRole).value<TaskId>();
+    bool isCompleted = index.data(TaskListModel::CompletedRole).toBool();
+    bool isUrgent = index.data(TaskListModel::UrgentRole).toBool();
+    QString text = index.data(Qt::DisplayRole).toString();
+    Action action = actionAt(option.rect, mouseEvent->position().toPoint(), isUrgent);
+
+    // Handlers rebuild the model, so emit once the view has finished with this event
+    auto post = [this](auto emitter) {
+        QMetaObject::invokeMethod(this, emitter, Qt::QueuedConnection);
+    };
+
+    if (event->type() == QEvent::MouseButtonPress) {
+        // Clicking the row body opens the editor right away, buttons act on release
+        if (action == Action::None) {
+            post([this, id, text]() { emit editRequested(id, text); });
+        }
+        return true;
+    }
+
+    switch (action) {
+    case Action::Snooze:
+        post([this, id]() { emit snoozeRequested(id); });
+        break;
+    case Action::Done:
+        post([this, id, isCompleted]() { emit doneRequested(id, !isCompleted); }); // Toggle
+        break;
+    case Action::Delete:
+        post([this, id]() { emit deleteRequested(id); });
+        break;
+    case Action::None:
+        break;
+    }
+    return true;
+}
+
+bool TaskItemDelegate::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_view->viewport()) {
+        if (event->type() == QEvent::MouseMove) {
+            m_hoverPos = static_cast<QMouseEvent*>(event)->position().toPoint();
+
+            QModelIndex index = m_view->indexAt(m_hoverPos);
+            Action action = Action::None;
+            if (!m_readOnly && index.isValid()) {
+                action = actionAt(m_view->visualRect(index), m_hoverPos, index.data(TaskListModel::UrgentRole).toBool());
+            }
+
+            // Only the row left and the row entered change, and only when the row or the hot button does
+            if (m_hoverIndex != index || action != m_hoverAction) {
+                m_view->viewport()->setCursor(action != Action::None ? Qt::PointingHandCursor : Qt::ArrowCursor);
+                updateRow(m_hoverIndex);
+                updateRow(index);
+                m_hoverIndex = index;
+                m_hoverAction = action;
+            }
+        } else if (event->type() == QEvent::Leave) {
+            m_hoverPos = QPoint(-1, -1);
+            m_view->viewport()->unsetCursor();
+            updateRow(m_hoverIndex);
+            m_hoverIndex = QPersistentModelIndex();
+            m_hoverAction = Action::None;
+        }
+    }
+    // The viewport isn't an editor, so QStyledItemDelegate's editor handling must not see it
+    return QObject::eventFilter(watched, event);
+}
@@ -0,0 +1,453 @@
+#include "TaskListModel.h"
+#include "utils/TaskOrdering.h"
+#include <QDateTime>
+#include <algorithm>
+
+namespace {
+// Past this many pending tasks, laying out every row again is cheaper than replaying them
+constexpr size_t kMaxIncrementalChanges = 256;
+}
+
+TaskListModel::TaskListModel(const TaskStorage* storage, const AlarmScheduler* alarms, QObject *parent)
+    : QAbstractListModel(parent), m_storage(storage), m_alarms(alarms)
+{
+    connect(m_storage, &TaskStorage::taskInserted, this, &TaskListModel::onTaskInserted);
+    connect(m_storage, &TaskStorage::taskChanged, this, &TaskListModel::onTaskChanged);
+    connect(m_storage, &TaskStorage::taskRemoved, this, &TaskListModel::onTaskRemoved);
+    connect(m_storage, &TaskStorage::tasksAppended, this, &TaskListModel::onTasksAppended);
+    connect(m_storage, &TaskStorage::reloaded, this, &TaskListModel::onStorageReloaded);
+    if (m_alarms) {
+        connect(m_alarms, &AlarmScheduler::alarmDue, this, &TaskListModel::onUrgencyChanged);
+    }
+    connect(&m_refresh, &RefreshCoalescer::refresh, this, &TaskListModel::applyPendingChanges);
+    reload();
+}
+
+int TaskListModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) return 0;
+    return static_cast<int>(m_rows.size());
+}
+
+QVariant TaskListModel::data(const QModelIndex& index, int role) const
+{
+    const TaskItem* task = taskAt(index.row());
+    if (!index.isValid() || !task) return QVariant();
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return task->text;
+    case IdRole:
+        return QVariant::fromValue(task->id);
+    case CompletedRole:
+        return task->isCompleted;
+    case UrgentRole:
+        return isUrgent(*task);
+    case AlarmTimeRole:
+        return task->alarmTime;
+    default:
+        return QVariant();
+    }
+}
+
+void TaskListModel::reload()
+{
+    beginResetModel();
+
+    // Every pending change is part of the rebuild
+    m_pending.clear();
+    m_refresh.cancel();
+
+    m_reloadTime = QDateTime::currentMSecsSinceEpoch();
+    if (m_filter.isEmpty()) {
+        m_rows = TaskOrdering::displayOrder(m_storage->tasks(), [this](const TaskItem& t) { return isUrgent(t); });
+    } else {
+        m_rows = filteredOrder();
+    }
+    resetRowIndex();
+
+    endResetModel();
+}
+
+void TaskListModel::onStorageReloaded()
+{
+    // The whole list may have been replaced, so the search index starts over too
+    m_index.clear();
+    m_fuzzy.clear();
+    m_indexed = false;
+    reload();
+}
+
+void TaskListModel::setFilter(const QString& text)
+{
+    if (text == m_filter) return;
+
+    // Narrowing works on the rows shown, so they have to be current first
+    flushPendingChanges();
+
+    beginResetModel();
+
+    // Typing on narrows the rows already shown, which are in display order
+    bool narrowing = !m_fuzzyResults && !m_filter.isEmpty() && text.contains(m_filter, Qt::CaseInsensitive);
+    m_filter = text;
+    if (m_filter.isEmpty()) {
+        m_reloadTime = QDateTime::currentMSecsSinceEpoch();
+        m_rows = TaskOrdering::displayOrder(m_storage->tasks(), [this](const TaskItem& t) { return isUrgent(t); });
+        m_fuzzyResults = false;
+    } else if (narrowing) {
+        m_rows.erase(std::remove_if(m_rows.begin(), m_rows.end(), [this](TaskId id) {
+            return !m_index.matches(id, m_filter);
+        }), m_rows.end());
+        if (m_rows.empty()) m_rows = filteredOrder();
+    } else {
+        m_rows = filteredOrder();
+    }
+    resetRowIndex();
+
+    endResetModel();
+}
+
+void TaskListModel::ensureIndex()
+{
+    if (m_indexed) return;
+    for (const TaskItem& t : m_storage->tasks()) {
+        m_index.insert(t.id, t.text);
+        m_fuzzy.insert(t.id, t.text);
+    }
+    m_indexed = true;
+}
+
+bool TaskListModel::passesFilter(TaskId id) const
+{
+    return m_filter.isEmpty() || m_index.matches(id, m_filter);
+}
+
+std::vector<TaskId> TaskListModel::filteredOrder()
+{
+    ensureIndex();
+
+    std::vector<std::pair<SortKey, TaskId>> keyed;
+    for (TaskId id : m_index.search(m_filter)) {
+        keyed.push_back({ sortKey(id), id });
+    }
+    std::sort(keyed.begin(), keyed.end());
+
+    std::vector<TaskId> ids;
+    m_fuzzyResults = keyed.empty();
+    if (m_fuzzyResults) {
+        for (const FuzzyMatcher::Match& match : m_fuzzy.search(m_filter)) {
+            ids.push_back(match.id);
+        }
+        return ids;
+    }
+
+    ids.reserve(keyed.size());
+    for (const auto& k : keyed) {
+        ids.push_back(k.second);
+    }
+    return ids;
+}
+
+int TaskListModel::rowOf(TaskId id) const
+{
+    auto it = m_rowById.find(id);
+    if (it != m_rowById.end() && it->second < m_rowByIdValid) return it->second;
+
+    // Rows at and after the first one that shifted are indexed again, once per change
+    int rows = rowCount();
+    if (m_rowByIdValid < rows) {
+        for (int row = m_rowByIdValid; row < rows; ++row) {
+            m_rowById[m_rows[row]] = row;
+        }
+        m_rowByIdValid = rows;
+        it = m_rowById.find(id);
+    }
+    return it != m_rowById.end() ? it->second : -1;
+}
+
+void TaskListModel::resetRowIndex()
+{
+    m_rowById.clear();
+    m_rowByIdValid = 0;
+}
+
+void TaskListModel::rowsShiftedFrom(int row)
+{
+    m_rowByIdValid = std::min(m_rowByIdValid, row);
+}
+
+void TaskListModel::removeRows(int first, int last)
+{
+    beginRemoveRows(QModelIndex(), first, last);
+    for (int row = first; row <= last; ++row) {
+        m_rowById.erase(m_rows[row]);
+    }
+    m_rows.erase(m_rows.begin() + first, m_rows.begin() + last + 1);
+    rowsShiftedFrom(first);
+    endRemoveRows();
+}
+
+const TaskItem* TaskListModel::taskAt(int row) const
+{
+    if (row < 0 || static_cast<size_t>(row) >= m_rows.size()) return nullptr;
+    return m_storage->find(m_rows[row]);
+}
+
+bool TaskListModel::isUrgent(const TaskItem& task) const
+{
+    if (m_alarms) return !task.isCompleted && m_alarms->isDue(task.id);
+    return TaskOrdering::isUrgent(task, m_reloadTime);
+}
+
+TaskListModel::SortKey TaskListModel::sortKey(TaskId id) const
+{
+    const TaskItem& task = *m_storage->find(id);
+    return { TaskOrdering::bucketOf(task, isUrgent(task)), m_storage->indexOf(id) };
+}
+
+int TaskListModel::lowerBound(int first, int last, const SortKey& key) const
+{
+    auto it = std::lower_bound(m_rows.begin() + first, m_rows.begin() + last, key, [this](TaskId id, const SortKey& k) {
+        return sortKey(id) < k;
+    });
+    return static_cast<int>(it - m_rows.begin());
+}
+
+void TaskListModel::insertRow(TaskId id)
+{
+    int row = lowerBound(0, rowCount(), sortKey(id));
+    beginInsertRows(QModelIndex(), row, row);
+    m_rows.insert(m_rows.begin() + row, id);
+    rowsShiftedFrom(row);
+    endInsertRows();
+}
+
+bool TaskListModel::refreshFuzzyResults()
+{
+    // Ranked rows have no display order to insert into, so they are searched again
+    if (!m_fuzzyResults) return false;
+
+    beginResetModel();
+    m_rows = filteredOrder();
+    resetRowIndex();
+    endResetModel();
+    return true;
+}
+
+void TaskListModel::onTaskInserted(TaskId id)
+{
+    if (m_indexed) {
+        m_index.insert(id, m_storage->find(id)->text);
+        m_fuzzy.insert(id, m_storage->find(id)->text);
+    }
+    markPending(id);
+}
+
+void TaskListModel::onTaskChanged(TaskId id)
+{
+    if (m_indexed) {
+        m_index.update(id, m_storage->find(id)->text);
+        m_fuzzy.update(id, m_storage->find(id)->text);
+    }
+    markPending(id);
+}
+
+void TaskListModel::onUrgencyChanged(TaskId id)
+{
+    // Ranked rows don't move with urgency, the row is only repainted
+    if (m_fuzzyResults) {
+        int row = rowOf(id);
+        if (row >= 0) emit dataChanged(index(row), index(row));
+        return;
+    }
+
+    // A task without a row is either filtered out or still to be placed, by a pending
+    // insert or by the chunk it is being appended with, which read the due set anyway
+    if (rowOf(id) < 0) return;
+    markPending(id);
+}
+
+void TaskListModel::markPending(TaskId id)
+{
+    m_pending.insert(id);
+    m_refresh.request();
+}
+
+void TaskListModel::applyPendingChanges()
+{
+    std::unordered_set<TaskId> pending;
+    pending.swap(m_pending);
+    if (pending.empty()) return;
+
+    if (refreshFuzzyResults()) return;
+
+    // The common case, one click: at most one row moves
+    if (pending.size() == 1) {
+        TaskId id = *pending.begin();
+        int row = rowOf(id);
+        if (m_storage->find(id)) {
+            repositionRow(id);
+        } else if (row >= 0) {
+            removeRows(row, row);
+        }
+        return;
+    }
+
+    if (pending.size() > kMaxIncrementalChanges) {
+        reload();
+        return;
+    }
+
+    // Rows of removed and filtered-out tasks go first, one contiguous run at a time from the bottom
+    auto dropped = [this, &pending](TaskId id) {
+        return pending.count(id) && !(m_storage->find(id) && passesFilter(id));
+    };
+    for (int row = rowCount() - 1; row >= 0; --row) {
+        if (!dropped(m_rows[row])) continue;
+        int last = row;
+        while (row > 0 && dropped(m_rows[row - 1])) --row;
+        removeRows(row, last);
+    }
+
+    // Every row left is a live task, but the changed ones may now be out of place
+    sortRows();
+
+    std::unordered_set<TaskId> shown;
+    for (TaskId id : m_rows) {
+        if (pending.count(id)) shown.insert(id);
+    }
+    for (TaskId id : pending) {
+        if (!shown.count(id) && m_storage->find(id) && passesFilter(id)) insertRow(id);
+    }
+
+    // Edited rows that stayed are repainted with a single dataChanged over their span
+    int first = -1;
+    int last = -1;
+    for (int row = 0; row < rowCount(); ++row) {
+        if (!shown.count(m_rows[row])) continue;
+        if (first < 0) first = row;
+        last = row;
+    }
+    if (first >= 0) emit dataChanged(index(first), index(last));
+}
+
+void TaskListModel::sortRows()
+{
+    std::vector<std::pair<SortKey, TaskId>> keyed;
+    keyed.reserve(m_rows.size());
+    for (TaskId id : m_rows) {
+        keyed.push_back({ sortKey(id), id });
+    }
+    if (std::is_sorted(keyed.begin(), keyed.end())) return;
+
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+    // Persistent indexes (current row, hover, selection) follow their task
+    const QModelIndexList before = persistentIndexList();
+    std::vector<TaskId> ids;
+    ids.reserve(before.size());
+    for (const QModelIndex& i : before) {
+        ids.push_back(m_rows[i.row()]);
+    }
+
+    std::sort(keyed.begin(), keyed.end());
+    for (size_t i = 0; i < keyed.size(); ++i) {
+        m_rows[i] = keyed[i].second;
+    }
+    resetRowIndex();
+
+    QModelIndexList after;
+    after.reserve(before.size());
+    for (TaskId id : ids) {
+        after.push_back(index(rowOf(id)));
+    }
+    changePersistentIndexList(before, after);
+
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+void TaskListModel::repositionRow(TaskId id)
+{
+    if (!m_storage->find(id)) return;
+
+    // An edit can move a task into or out of the search results
+    int from = rowOf(id);
+    bool passes = passesFilter(id);
+    if (from < 0) {
+        if (passes) insertRow(id);
+        return;
+    }
+    if (!passes) {
+        removeRows(from, from);
+        return;
+    }
+
+    // Every other row is still ordered, so search the two sides around the changed one
+    SortKey key = sortKey(id);
+    int to = lowerBound(0, from, key);
+    if (to == from) {
+        to = lowerBound(from + 1, rowCount(), key) - 1;
+    }
+
+    if (to == from) {
+        QModelIndex changed = index(from);
+        emit dataChanged(changed, changed);
+        return;
+    }
+
+    // beginMoveRows takes the destination in pre-move coordinates
+    beginMoveRows(QModelIndex(), from, from, QModelIndex(), to > from ? to + 1 : to);
+    m_rows.erase(m_rows.begin() + from);
+    m_rows.insert(m_rows.begin() + to, id);
+    rowsShiftedFrom(std::min(from, to));
+    endMoveRows();
+
+    QModelIndex moved = index(to);
+    emit dataChanged(moved, moved);
+}
+
+void TaskListModel::onTaskRemoved(TaskId id)
+{
+    if (m_indexed) {
+        m_index.remove(id);
+        m_fuzzy.remove(id);
+    }
+    markPending(id);
+}
+
+void TaskListModel::onTasksAppended(int first, int count)
+{
+    // Appended tasks come after every existing one in storage order, so within each
+    // bucket they go to the end of its rows: at most one contiguous insert per bucket.
+    // That needs every existing row in place, so pending changes are applied first.
+    flushPendingChanges();
+
+    std::vector<TaskId> byBucket[3];
+    const std::vector<TaskItem>& tasks = m_storage->tasks();
+    if (m_indexed) {
+        for (int i = first; i < first + count; ++i) {
+            m_index.insert(tasks[i].id, tasks[i].text);
+            m_fuzzy.insert(tasks[i].id, tasks[i].text);
+        }
+    }
+    if (refreshFuzzyResults()) return;
+
+    for (int i = first; i < first + count; ++i) {
+        // Flushing may have laid out every row again, this chunk included
+        if (rowOf(tasks[i].id) >= 0) continue;
+        if (passesFilter(tasks[i].id)) {
+            byBucket[TaskOrdering::bucketOf(tasks[i], isUrgent(tasks[i]))].push_back(tasks[i].id);
+        }
+    }
+
+    for (int bucket = 0; bucket < 3; ++bucket) {
+        const std::vector<TaskId>& ids = byBucket[bucket];
+        if (ids.empty()) continue;
+
+        int row = lowerBound(0, rowCount(), { bucket + 1, -1 });
+        beginInsertRows(QModelIndex(), row, row + static_cast<int>(ids.size()) - 1);
+        m_rows.insert(m_rows.begin() + row, ids.begin(), ids.end());
+        rowsShiftedFrom(row);
+        endInsertRows();
+    }
+}
@@ -3,17 +3,15 @@
 #include <QApplication>
 #include <QPainter>
 #include <QStyleOption>
-#include "TaskItemWidget.h"
-#include <QListWidgetItem>
-#include <QEnterEvent>
+#include <QShortcut>
+#include <algorithm>
+#include "TaskListModel.h"
+#include "ArchiveListModel.h"
+#include "TaskItemDelegate.h"
 #include "TaskEditModal.h"
-#include <QFont>
-#include <QFontMetrics>
-#include <QDateTime>
-#include <QTimer>
 
-TaskPopup::TaskPopup(QWidget *parent)
-    : QWidget(parent)
+TaskPopup::TaskPopup(const TaskStorage* storage, const AlarmScheduler* alarms, QWidget *parent)
+    : QWidget(parent), m_storage(storage)
 {
     setWindowFlags(Qt::Tool | Qt::FramelessWindowHint | Qt::NoDropShadowWindowHint);
     setAttribute(Qt::WA_TranslucentBackground);
@@ -35,23 +33,11 @@ TaskPopup::TaskPopup(QWidget *parent)
             color: white;
             font-size: 14px;
         }
-        QListWidget {
+        QListView {
             background: transparent;
             border: none;
             outline: none;
         }
-        QListWidget::item {
-            background: transparent;
-            border: none;
-        }
-        QListWidget::item:hover {
-            background: transparent;
-            border: none;
-        }
-        QListWidget::item:selected {
-            background: transparent;
-            border: none;
-        }
     )");
 
     auto* layout = new QVBoxLayout(this);
@@ -61,115 +47,144 @@ TaskPopup::TaskPopup(QWidget *parent)
     m_inputField = new QLineEdit(this);
     m_inputField->setPlaceholderText("Enter a new task...");
     
-    m_taskList = new QListWidget(this);
+    m_taskList = new QListView(this);
     m_taskList->setFocusPolicy(Qt::NoFocus);
     m_taskList->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     m_taskList->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    m_taskList->setSelectionMode(QAbstractItemView::NoSelection);
+    m_taskList->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_taskList->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    // Lay rows out in batches so opening a huge list only measures what is needed for the first paint
+    m_taskList->setLayoutMode(QListView::Batched);
+    m_taskList->setBatchSize(100);
+
+    m_model = new TaskListModel(storage, alarms, this);
+    m_historyModel = new ArchiveListModel(this);
+    m_delegate = new TaskItemDelegate(m_taskList);
+    m_taskList->setModel(m_model);
+    m_taskList->setItemDelegate(m_delegate);
+
+    // Every mutation shows as unsaved until the writer acknowledges it
+    connect(storage, &TaskStorage::taskInserted, this, qOverload<>(&QWidget::update));
+    connect(storage, &TaskStorage::taskChanged, this, qOverload<>(&QWidget::update));
+    connect(storage, &TaskStorage::taskRemoved, this, qOverload<>(&QWidget::update));
+    connect(storage, &TaskStorage::persisted, this, qOverload<>(&QWidget::update));
+    connect(m_model, &QAbstractItemModel::dataChanged, m_delegate, &TaskItemDelegate::remeasure);
+
+    connect(m_delegate, &TaskItemDelegate::deleteRequested, this, &TaskPopup::taskDeleted);
+    connect(m_delegate, &TaskItemDelegate::doneRequested, this, &TaskPopup::taskDone);
+    connect(m_delegate, &TaskItemDelegate::snoozeRequested, this, &TaskPopup::taskSnoozed);
+    connect(m_delegate, &TaskItemDelegate::editRequested, this, &TaskPopup::onTaskEditRequested);
+
+    // 1-second SkyBlue flash for rows reached through the side panel
+    m_flashTimer = new QTimer(this);
+    m_flashTimer->setSingleShot(true);
+    m_flashTimer->setInterval(1000);
+    connect(m_flashTimer, &QTimer::timeout, this, [this]() {
+        m_delegate->setFlashedId(0);
+    });
 
     layout->addWidget(m_inputField);
     layout->addWidget(m_taskList);
 
     connect(m_inputField, &QLineEdit::returnPressed, this, &TaskPopup::onReturnPressed);
+    connect(m_inputField, &QLineEdit::textChanged, this, &TaskPopup::onInputChanged);
+
+    // Ctrl+F turns the input into a search box that filters the list as you type
+    auto* findShortcut = new QShortcut(QKeySequence::Find, this);
+    connect(findShortcut, &QShortcut::activated, this, [this]() { setSearchMode(!m_searchMode); });
+
+    // Ctrl+H shows the archived tasks, which are only read from disk at that point
+    auto* historyShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_H), this);
+    connect(historyShortcut, &QShortcut::activated, this, [this]() { setHistoryMode(!m_historyMode); });
 }
 
-void TaskPopup::reloadTasks(const std::vector<TaskItem>& tasks)
+void TaskPopup::setHistoryMode(bool enabled)
 {
-    m_taskList->clear();
-    int index = 0;
-    
-    QFont font;
-    font.setPixelSize(14);
-    QFontMetrics fm(font);
-    
-    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (enabled == m_historyMode) return;
+    m_historyMode = enabled;
 
-    // Create a mutable copy to sort
-    std::vector<TaskItem> sortedTasks = tasks;
-    
-    // Stable sort: Urgent (uncompleted + expired alarm) > Uncompleted > Completed
-    std::stable_sort(sortedTasks.begin(), sortedTasks.end(), [now](const TaskItem& a, const TaskItem& b) {
-        bool aUrgent = !a.isCompleted && a.alarmTime > 0 && now >= a.alarmTime;
-        bool bUrgent = !b.isCompleted && b.alarmTime > 0 && now >= b.alarmTime;
-        
-        if (aUrgent && !bUrgent) return true;
-        if (!aUrgent && bUrgent) return false;
-        if (!a.isCompleted && b.isCompleted) return true;
-        if (a.isCompleted && !b.isCompleted) return false;
-        return false; // Preserve original order otherwise
+    if (!enabled) {
+        m_taskList->setModel(m_model);
+        m_historyModel->clear();
+        m_delegate->setReadOnly(false);
+        m_inputField->setReadOnly(false);
+        m_inputField->setPlaceholderText("Enter a new task...");
+        return;
+    }
+
+    setSearchMode(false);
+
+    // Most recently completed first
+    std::vector<TaskItem> archived = m_storage->loadArchive();
+    std::stable_sort(archived.begin(), archived.end(), [](const TaskItem& a, const TaskItem& b) {
+        return a.completedAt > b.completedAt;
     });
 
-    for (const auto& task : sortedTasks)
-    {
-        bool isUrgent = !task.isCompleted && task.alarmTime > 0 && now >= task.alarmTime;
-        auto* item = new QListWidgetItem(m_taskList);
-        
-        QString displayText = task.text;
-        if (displayText.length() > 90) {
-            displayText = displayText.left(86) + "...";
-        }
-        
-        // Physically simulate word-wrapping across the 188px label bounds
-        int textH = fm.boundingRect(0, 0, 188, 0, Qt::TextWordWrap, displayText).height();
-        
-        int computedHeight = 38; // 1 line default
-        if (textH > 40) {
-            computedHeight = 84; // 3+ lines mapped
-        } else if (textH > 20) {
-            computedHeight = 60; // 2 lines mapped
-        }
-        item->setSizeHint(QSize(0, computedHeight));
-        
-        m_taskList->addItem(item);
-
-        // Map visual index back to the real storage index by finding the text match
-        // Since text is the only unique identifier we have in tasks.json right now
-        int realIndex = -1;
-        for (size_t i = 0; i < tasks.size(); ++i) {
-            if (tasks[i].text == task.text && tasks[i].isCompleted == task.isCompleted && tasks[i].alarmTime == task.alarmTime) {
-                realIndex = static_cast<int>(i);
-                break;
-            }
-        }
+    bool empty = archived.empty();
+    m_historyModel->setTasks(std::move(archived));
+
+    m_taskList->setModel(m_historyModel);
+    m_delegate->setReadOnly(true);
+    m_inputField->setReadOnly(true);
+    m_inputField->setPlaceholderText(empty ? "No archived tasks yet" : "History - Ctrl+H to go back");
+}
 
-        auto* widget = new TaskItemWidget(task.text, realIndex, task.isCompleted, isUrgent, this);
-        connect(widget, &TaskItemWidget::deleteRequested, this, &TaskPopup::taskDeleted);
-        connect(widget, &TaskItemWidget::doneRequested, this, &TaskPopup::taskDone);
-        connect(widget, &TaskItemWidget::snoozeRequested, this, &TaskPopup::taskSnoozed);
-        connect(widget, &TaskItemWidget::editRequested, this, &TaskPopup::onTaskEditRequested);
-        m_taskList->setItemWidget(item, widget);
-        
-        index++;
+void TaskPopup::setSearchMode(bool enabled)
+{
+    if (enabled == m_searchMode) return;
+    if (enabled) setHistoryMode(false);
+    m_searchMode = enabled;
+
+    if (enabled) {
+        m_draft = m_inputField->text();
+        m_inputField->clear();
+        m_inputField->setPlaceholderText("Search tasks...");
+    } else {
+        m_inputField->setText(m_draft);
+        m_inputField->setPlaceholderText("Enter a new task...");
+        m_model->setFilter(QString());
+        m_delegate->setHighlight(QString());
     }
+    m_inputField->setFocus();
 }
 
-void TaskPopup::scrollToTask(int targetIndex)
+void TaskPopup::onInputChanged(const QString& text)
 {
-    // We must find the visual item representing the real tasks.json index
-    for (int i = 0; i < m_taskList->count(); ++i) {
-        QListWidgetItem* item = m_taskList->item(i);
-        auto* widget = qobject_cast<TaskItemWidget*>(m_taskList->itemWidget(item));
-        
-        if (widget && widget->getIndex() == targetIndex) {
-            m_taskList->scrollToItem(item, QAbstractItemView::PositionAtCenter);
-            
-            // Trigger 1-second SkyBlue flash
-            QString originalStyle = widget->styleSheet();
-            widget->setStyleSheet(originalStyle + R"(
-                #TaskItem { border: 2px solid rgba(135, 206, 235, 1); }
-            )");
-            
-            QTimer::singleShot(1000, widget, [widget, originalStyle]() {
-                if (widget) {
-                    widget->setStyleSheet(originalStyle);
-                }
-            });
-            break;
-        }
+    if (!m_searchMode) return;
+
+    QString query = text.trimmed();
+    m_model->setFilter(query);
+    m_delegate->setHighlight(query);
+}
+
+void TaskPopup::setRefreshWindow(int ms)
+{
+    m_model->setRefreshWindow(ms);
+}
+
+void TaskPopup::scrollToTask(TaskId targetId)
+{
+    m_model->flushPendingChanges();
+
+    // The side panel lists every alarm, so a filtered-out task ends the search
+    setHistoryMode(false);
+    if (m_searchMode && m_model->rowOf(targetId) < 0) {
+        setSearchMode(false);
     }
+
+    int row = m_model->rowOf(targetId);
+    if (row < 0) return;
+
+    m_taskList->scrollTo(m_model->index(row), QAbstractItemView::PositionAtCenter);
+    m_delegate->setFlashedId(targetId);
+    m_flashTimer->start();
 }
 
 void TaskPopup::onReturnPressed()
 {
+    if (m_searchMode || m_historyMode) return;
+
     QString text = m_inputField->text().trimmed();
     if (!text.isEmpty()) {
         emit taskAdded(text);
@@ -177,7 +192,7 @@ void TaskPopup::onReturnPressed()
     }
 }
 
-void TaskPopup::onTaskEditRequested(int index, const QString& text)
+void TaskPopup::onTaskEditRequested(TaskId id, const QString& text)
 {
     auto* modal = new TaskEditModal(text, this);
     
@@ -186,8 +201,8 @@ void TaskPopup::onTaskEditRequested(int index, const QString& text)
     int my = rect().center().y() - modal->height() / 2;
     modal->move(mapToGlobal(QPoint(mx, my)));
     
-    connect(modal, &TaskEditModal::saveRequested, this, [this, index, modal](const QString& newText) {
-        emit taskEdited(index, newText);
+    connect(modal, &TaskEditModal::saveRequested, this, [this, id, modal](const QString& newText) {
+        emit taskEdited(id, newText);
         modal->deleteLater();
     });
     connect(modal, &TaskEditModal::cancelRequested, modal, &QObject::deleteLater);
@@ -198,7 +213,14 @@ void TaskPopup::onTaskEditRequested(int index, const QString& text)
 void TaskPopup::keyPressEvent(QKeyEvent *event)
 {
     if (event->key() == Qt::Key_Escape) {
-        hide();
+        // Escape leaves search or history first, a second one closes the popup
+        if (m_historyMode) {
+            setHistoryMode(false);
+        } else if (m_searchMode) {
+            setSearchMode(false);
+        } else {
+            hide();
+        }
     } else if (event->key() == Qt::Key_Return || event->key() == Qt::Key_Enter) {
         // Explicitly forward Enter to the input field if it has focus to avoid key swallow
         if (m_inputField->hasFocus()) {
@@ -216,11 +238,21 @@ void TaskPopup::paintEvent(QPaintEvent *event)
     opt.initFrom(this);
     QPainter p(this);
     style()->drawPrimitive(QStyle::PE_Widget, &opt, &p, this);
+
+    // Amber dot in the corner while a change hasn't reached the disk yet
+    if (m_storage->hasUnsavedChanges()) {
+        p.setRenderHint(QPainter::Antialiasing);
+        p.setPen(Qt::NoPen);
+        p.setBrush(QColor(251, 191, 36));
+        p.drawEllipse(QPointF(width() - 7, 7), 3, 3);
+    }
 }
 
 void TaskPopup::hideEvent(QHideEvent *event)
 {
     QWidget::hideEvent(event);
+    setSearchMode(false);
+    setHistoryMode(false);
     emit popupHidden();
 }
 
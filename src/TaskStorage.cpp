@@ -1,129 +1,858 @@
 #include "TaskStorage.h"
 #include <QFile>
+#include <QSaveFile>
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QStandardPaths>
 #include <QDir>
+#include <QFileInfo>
 #include <QCoreApplication>
 #include <QDateTime>
+#include <QThread>
+#include <QMutexLocker>
+#include <algorithm>
+#include <unordered_set>
+#include "StorageWriter.h"
+#include "BinarySnapshot.h"
+#include "JsonTaskReader.h"
 #include "utils/SmartParser.h"
 
-TaskStorage::TaskStorage()
+TaskStorage::TaskStorage(QObject *parent)
+    : TaskStorage(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation), parent)
 {
-    QString appDataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-    QDir dir(appDataDir);
+}
+
+TaskStorage::TaskStorage(const QString& directory, QObject *parent)
+    : QObject(parent)
+{
+    QDir dir(directory);
     if (!dir.exists()) {
         dir.mkpath(".");
     }
     m_filename = dir.filePath("tasks.json");
+    m_journalFilename = dir.filePath("tasks.journal");
+    m_binaryFilenames[0] = dir.filePath("tasks.0.bin");
+    m_binaryFilenames[1] = dir.filePath("tasks.1.bin");
+    m_archiveFilename = dir.filePath("tasks.archive");
+
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(500);
+    connect(&m_flushTimer, &QTimer::timeout, this, &TaskStorage::flush);
+
+    // Disk writes happen on the writer thread, acknowledgements come back queued
+    m_writer = std::make_unique<StorageWriter>(QStringList{ m_filename, m_binaryFilenames[0], m_binaryFilenames[1] }, m_journalFilename);
+    connect(m_writer.get(), &StorageWriter::persisted, this, &TaskStorage::onPersisted);
+    connect(m_writer.get(), &StorageWriter::compactionFinished, this, &TaskStorage::onCompactionFinished);
+    connect(m_writer.get(), &StorageWriter::archiveFinished, this, &TaskStorage::onArchiveFinished);
+
+    m_archiveTimer.setInterval(60 * 60 * 1000);
+    connect(&m_archiveTimer, &QTimer::timeout, this, &TaskStorage::archiveCompleted);
+
+    // A pending write-back must not be lost on a normal shutdown
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &TaskStorage::sync);
+    }
+
+    m_archivedNextId = readArchivedNextId(m_archiveFilename);
+    m_nextId = m_archivedNextId;
+    loadFromDisk();
+}
+
+TaskStorage::~TaskStorage()
+{
+    // Nothing can have changed while loading, mutations wait for the load to complete
+    if (m_loaderThread) {
+        m_abortLoad = true;
+        m_loaderThread->wait();
+        delete m_loaderThread;
+        m_loaderThread = nullptr;
+    }
+    sync();
+    disconnect(m_writer.get(), nullptr, this, nullptr);
+    m_writer.reset();
+}
+
+QJsonObject taskToJson(const TaskItem& t)
+{
+    QJsonObject obj;
+    obj["id"] = static_cast<qint64>(t.id);
+    obj["text"] = t.text;
+    obj["isCompleted"] = t.isCompleted;
+    obj["alarmTime"] = t.alarmTime;
+    if (t.completedAt > 0) obj["completedAt"] = t.completedAt;
+    return obj;
 }
 
-void saveInternal(const QString& filename, const std::vector<TaskItem>& tasks)
+TaskItem taskFromJson(const QJsonObject& obj)
+{
+    return {
+        static_cast<TaskId>(obj["id"].toInteger(0)),
+        obj["text"].toString(),
+        obj["isCompleted"].toBool(),
+        static_cast<qint64>(obj["alarmTime"].toDouble(0)),
+        static_cast<qint64>(obj["completedAt"].toDouble(0))
+    };
+}
+
+// Journaled snapshots carry the sequence number of the last record they include, so
+// journal records that were already folded in are skipped on replay. Called on the
+// StorageWriter thread.
+bool saveInternal(const QString& filename, const std::vector<TaskItem>& tasks, qint64 seq)
 {
     QJsonArray array;
     for (const auto& t : tasks) {
-        QJsonObject obj;
-        obj["text"] = t.text;
-        obj["isCompleted"] = t.isCompleted;
-        obj["alarmTime"] = t.alarmTime;
-        array.append(obj);
+        array.append(taskToJson(t));
     }
 
-    QJsonDocument doc(array);
-    QFile file(filename);
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        file.write(doc.toJson());
-        file.close();
-    }
-}
-
-std::vector<TaskItem> TaskStorage::load()
-{
-    std::vector<TaskItem> tasks;
-    QFile file(m_filename);
-    
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-        return tasks;
-
-    QByteArray data = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (doc.isArray()) {
-        QJsonArray array = doc.array();
-        tasks.reserve(array.size());
-        for (const QJsonValue& val : array) {
-            if (val.isObject()) {
-                QJsonObject obj = val.toObject();
-                tasks.push_back({
-                    obj["text"].toString(),
-                    obj["isCompleted"].toBool(),
-                    static_cast<qint64>(obj["alarmTime"].toDouble(0))
-                });
+    QJsonDocument doc;
+    if (seq < 0) {
+        doc.setArray(array);
+    } else {
+        QJsonObject root;
+        root["seq"] = seq;
+        root["tasks"] = array;
+        doc.setObject(root);
+    }
+
+    // Written to a temporary file and renamed over tasks.json on commit, so a crash
+    // mid-write leaves the previous snapshot intact. commit() also syncs it to disk.
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+
+    QByteArray data = doc.toJson();
+    if (file.write(data) != data.size()) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+namespace {
+// The first chunk is small so the first rows show up quickly, later ones grow to cut overhead
+const size_t kFirstLoadChunk = 256;
+const size_t kMaxLoadChunk = 32768; // Large enough to keep every pool thread busy
+
+// Texts of a binary-loaded list point into its mapping and get copied freely (views,
+// caches, queued writes), so mappings are kept until the process exits. They are
+// file-backed and clean, so the OS can drop their pages whenever it likes.
+std::vector<std::unique_ptr<BinarySnapshot>>& retainedSnapshots()
+{
+    static std::vector<std::unique_ptr<BinarySnapshot>> snapshots;
+    return snapshots;
+}
+}
+
+bool TaskStorage::openBinary(const QString& filename)
+{
+    auto owned = std::make_unique<BinarySnapshot>();
+    if (!owned->open(filename))
+        return false;
+
+    // Opening only checked the header; records are built, and checked, on the loader thread
+    const BinarySnapshot* snapshot = owned.get();
+    retainedSnapshots().push_back(std::move(owned));
+    auto next = std::make_shared<size_t>(0);
+    startStreamingLoad([snapshot, next](std::vector<TaskItem>& chunk, size_t maxCount) {
+        size_t end = std::min(snapshot->count(), *next + maxCount);
+        for (; *next < end; ++*next) {
+            TaskItem task;
+            if (snapshot->taskAt(*next, task)) {
+                chunk.push_back(std::move(task)); // A record pointing outside the heap is dropped
+            }
+        }
+        return *next < snapshot->count();
+    }, [snapshot]() { return snapshot->seq(); });
+    return true;
+}
+
+void TaskStorage::loadFromDisk()
+{
+    m_tasks.clear();
+    qint64 snapshotSeq = 0;
+
+    // Normally only one snapshot exists, since writing one removes the others, but a
+    // mapped file can't be removed on Windows. The newest one is the current state.
+    struct Candidate { QFileInfo info; int slot; }; // slot -1 is tasks.json
+    std::vector<Candidate> candidates;
+    for (int slot = -1; slot < 2; ++slot) {
+        QFileInfo info(slot < 0 ? m_filename : m_binaryFilenames[slot]);
+        if (info.exists()) candidates.push_back({ info, slot });
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.info.lastModified() > b.info.lastModified();
+    });
+
+    // Either format is read on a background thread and published in chunks, see completeLoad
+    for (const Candidate& c : candidates) {
+        if (c.slot < 0) {
+            auto reader = std::make_shared<JsonTaskReader>(m_filename);
+            reader->setParallel(true);
+            if (reader->open()) {
+                startStreamingLoad([reader](std::vector<TaskItem>& chunk, size_t maxCount) {
+                    reader->readChunk(chunk, maxCount);
+                    return !reader->atEnd();
+                }, [reader]() { return reader->seq(); });
+                return;
             }
+        } else if (openBinary(m_binaryFilenames[c.slot])) {
+            // Keep writing in the format we found, into the slot that isn't mapped
+            m_format = SnapshotFormat::Binary;
+            m_binarySlot = 1 - c.slot;
+            return;
         }
     }
 
-    return tasks;
+    completeLoad(snapshotSeq);
+}
+
+void TaskStorage::startStreamingLoad(ChunkReader readChunk, std::function<qint64()> seq)
+{
+    m_loading = true;
+    m_publishing = true;
+
+    m_loaderThread = QThread::create([this, readChunk, seq]() {
+        size_t chunkSize = kFirstLoadChunk;
+        for (bool more = true; more && !m_abortLoad; ) {
+            std::vector<TaskItem> chunk;
+            chunk.reserve(chunkSize);
+            more = readChunk(chunk, chunkSize);
+            chunkSize = std::min(chunkSize * 2, kMaxLoadChunk);
+            if (chunk.empty())
+                continue;
+
+            QMutexLocker locker(&m_loadMutex);
+            m_loadedChunks.push_back(std::move(chunk));
+            if (!m_loadDrainScheduled) {
+                m_loadDrainScheduled = true;
+                QMetaObject::invokeMethod(this, &TaskStorage::drainLoadedChunks, Qt::QueuedConnection);
+            }
+        }
+        m_loadedSeq = seq();
+    });
+    connect(m_loaderThread, &QThread::finished, this, &TaskStorage::waitForLoad);
+    m_loaderThread->start();
+}
+
+void TaskStorage::drainLoadedChunks()
+{
+    std::vector<std::vector<TaskItem>> chunks;
+    {
+        QMutexLocker locker(&m_loadMutex);
+        chunks.swap(m_loadedChunks);
+        m_loadDrainScheduled = false;
+    }
+
+    for (std::vector<TaskItem>& chunk : chunks) {
+        size_t first = m_tasks.size();
+        for (TaskItem& t : chunk) {
+            // A task without a usable id gets one once the whole file is known, and from
+            // then on rows are only published by the reloaded() at the end
+            if (t.id == 0 || !m_indexById.emplace(t.id, m_tasks.size()).second) {
+                m_publishing = false;
+            }
+            m_nextId = std::max(m_nextId, t.id + 1);
+            m_tasks.push_back(std::move(t));
+        }
+        if (m_publishing) {
+            emit tasksAppended(static_cast<int>(first), static_cast<int>(m_tasks.size() - first));
+        }
+    }
+}
+
+void TaskStorage::waitForLoad()
+{
+    if (!m_loaderThread) return;
+
+    m_loaderThread->wait();
+    delete m_loaderThread;
+    m_loaderThread = nullptr;
+
+    drainLoadedChunks();
+    completeLoad(m_loadedSeq);
 }
 
-void TaskStorage::add(const QString& task)
+void TaskStorage::completeLoad(qint64 snapshotSeq)
 {
-    if (task.trimmed().isEmpty()) return;
+    // Files written before ids existed (or edited by hand) get fresh ids in file order.
+    // This is deterministic, so journal records made against them still replay correctly.
+    rebuildIndex();
+    bool assignedIds = false;
+    for (size_t i = 0; i < m_tasks.size(); ++i) {
+        auto it = m_indexById.find(m_tasks[i].id);
+        if (m_tasks[i].id == 0 || it == m_indexById.end() || it->second != i) {
+            m_tasks[i].id = m_nextId++;
+            assignedIds = true;
+        }
+    }
+    if (assignedIds) {
+        rebuildIndex();
+    }
+
+    m_seq = snapshotSeq;
+
+    // The journal is always replayed if present, whatever the current mode
+    replayJournal();
+    m_persistedSeq = m_seq;
+
+    // Rows published while streaming are stale if ids were assigned or the journal changed anything
+    bool streamed = m_loading;
+    m_loading = false;
+    if (streamed && (assignedIds || m_seq != snapshotSeq)) {
+        emit reloaded();
+    }
+    emit loadFinished();
+
+    if (assignedIds) {
+        // Persist the new ids right away rather than relying on re-deriving them
+        if (m_mode == StorageMode::Journaled) {
+            startCompaction();
+        } else {
+            markDirty();
+        }
+    } else {
+        maybeCompact();
+    }
+    archiveCompleted();
+}
+
+void TaskStorage::rebuildIndex()
+{
+    m_indexById.clear();
+    m_indexById.reserve(m_tasks.size());
+    m_nextId = m_archivedNextId;
+    for (size_t i = 0; i < m_tasks.size(); ++i) {
+        // emplace keeps the first occurrence, so a duplicated id maps to its first task
+        m_indexById.emplace(m_tasks[i].id, i);
+        m_nextId = std::max(m_nextId, m_tasks[i].id + 1);
+    }
+}
+
+const TaskItem* TaskStorage::find(TaskId id) const
+{
+    auto it = m_indexById.find(id);
+    return it != m_indexById.end() ? &m_tasks[it->second] : nullptr;
+}
+
+int TaskStorage::indexOf(TaskId id) const
+{
+    auto it = m_indexById.find(id);
+    return it != m_indexById.end() ? static_cast<int>(it->second) : -1;
+}
+
+void TaskStorage::replayJournal()
+{
+    m_journalRecords = 0;
+    m_journalBytes = 0;
+
+    QFile journal(m_journalFilename);
+    if (!journal.open(QIODevice::ReadOnly))
+        return;
+
+    qint64 completeBytes = 0; // Up to the end of the last line that has its newline
+    bool tailParsed = false;
+    while (!journal.atEnd()) {
+        QByteArray line = journal.readLine();
+        m_journalBytes += line.size();
+        if (line.endsWith('\n')) completeBytes = m_journalBytes;
+
+        // A torn last line from a crash mid-append simply fails to parse and is dropped
+        QJsonDocument doc = QJsonDocument::fromJson(line);
+        tailParsed = doc.isObject();
+        if (!doc.isObject())
+            continue;
+
+        QJsonObject record = doc.object();
+        qint64 seq = static_cast<qint64>(record["seq"].toDouble(0));
+        m_journalRecords++;
+        if (seq <= m_seq)
+            continue; // Already folded into the snapshot, or a duplicate from a retried append
+
+        applyRecord(record);
+        m_seq = seq;
+    }
+    journal.close();
+
+    // The next append must start on a line of its own, or it would be lost with the torn one
+    if (completeBytes < m_journalBytes) {
+        if (tailParsed) {
+            if (journal.open(QIODevice::WriteOnly | QIODevice::Append)) journal.write("\n");
+            m_journalBytes++;
+        } else {
+            QFile::resize(m_journalFilename, completeBytes);
+            m_journalBytes = completeBytes;
+        }
+    }
+}
+
+void TaskStorage::applyRecord(const QJsonObject& record)
+{
+    QString op = record["op"].toString();
+
+    if (op == "add") {
+        TaskItem item = taskFromJson(record);
+        if (item.id == 0 || m_indexById.count(item.id))
+            item.id = m_nextId;
+        m_nextId = std::max(m_nextId, item.id + 1);
+        m_indexById[item.id] = m_tasks.size();
+        m_tasks.push_back(item);
+        return;
+    }
+
+    if (op == "archive") {
+        std::vector<TaskId> ids;
+        for (const QJsonValue& id : record["ids"].toArray()) {
+            ids.push_back(static_cast<TaskId>(id.toInteger()));
+        }
+        eraseArchived(ids);
+        return;
+    }
+
+    int index = indexOf(static_cast<TaskId>(record["id"].toInteger()));
+    if (index < 0 || static_cast<size_t>(index) >= m_tasks.size())
+        return;
+
+    if (op == "update") {
+        m_tasks[index].text = record["text"].toString();
+        m_tasks[index].alarmTime = static_cast<qint64>(record["alarmTime"].toDouble(0));
+    } else if (op == "complete") {
+        m_tasks[index].isCompleted = record["isCompleted"].toBool();
+        m_tasks[index].completedAt = static_cast<qint64>(record["completedAt"].toDouble(0));
+    } else if (op == "snooze") {
+        m_tasks[index].alarmTime = static_cast<qint64>(record["alarmTime"].toDouble(0));
+    } else if (op == "remove") {
+        eraseAt(index);
+    }
+}
+
+void TaskStorage::eraseAt(int index)
+{
+    m_indexById.erase(m_tasks[index].id);
+    m_tasks.erase(m_tasks.begin() + index);
+    for (size_t i = index; i < m_tasks.size(); ++i) {
+        m_indexById[m_tasks[i].id] = i;
+    }
+}
+
+void TaskStorage::appendRecord(QJsonObject record)
+{
+    // Every mutation gets a sequence number, it is what persisted() acknowledges
+    record["seq"] = ++m_seq;
+    if (m_mode == StorageMode::Journaled) {
+        QByteArray line = QJsonDocument(record).toJson(QJsonDocument::Compact);
+        line.append('\n');
+        m_pendingJournal.append(line);
+    }
+    markDirty();
+}
+
+void TaskStorage::setWritePolicy(WritePolicy policy, int delayMs)
+{
+    m_writePolicy = policy;
+    m_flushTimer.setInterval(delayMs);
+
+    // Switching to write-through should not leave a deferred write behind
+    if (m_writePolicy == WritePolicy::WriteThrough) {
+        flush();
+    }
+}
+
+void TaskStorage::setStorageMode(StorageMode mode)
+{
+    waitForLoad();
+    if (mode == m_mode) return;
+
+    flush();
+    m_mode = mode;
+
+    if (m_mode == StorageMode::Snapshot) {
+        // Fold the journal in for good so the plain snapshot is self-contained,
+        // the writer removes the journal once the snapshot is written
+        queueSnapshot(false);
+        m_journalRecords = 0;
+        m_journalBytes = 0;
+    }
+}
+
+void TaskStorage::setCompactionThreshold(int maxRecords, qint64 maxBytes)
+{
+    m_maxJournalRecords = maxRecords;
+    m_maxJournalBytes = maxBytes;
+    maybeCompact();
+}
+
+void TaskStorage::markDirty()
+{
+    m_dirty = true;
+    if (m_writePolicy == WritePolicy::WriteThrough) {
+        flush();
+    } else if (!m_flushTimer.isActive()) {
+        // Don't restart a running timer, otherwise a steady stream of clicks could postpone the write forever
+        m_flushTimer.start();
+    }
+}
+
+void TaskStorage::flush()
+{
+    m_flushTimer.stop();
+    if (!m_dirty) return;
+    m_dirty = false;
+
+    if (m_mode == StorageMode::Snapshot) {
+        queueSnapshot(false);
+        return;
+    }
+
+    m_journalBytes += m_pendingJournal.size();
+    m_journalRecords += m_pendingJournal.count('\n');
+    m_writer->appendJournal(m_pendingJournal, m_seq);
+    m_pendingJournal.clear();
+
+    maybeCompact();
+}
+
+void TaskStorage::sync()
+{
+    flush();
+    m_writer->syncNow();
+    m_writer->waitForIdle();
+}
+
+void TaskStorage::setGroupCommitWindow(int ms)
+{
+    m_writer->setGroupCommitWindow(ms);
+}
+
+void TaskStorage::onPersisted(qint64 seq)
+{
+    if (seq <= m_persistedSeq) return;
+    m_persistedSeq = seq;
+    emit persisted(seq);
+}
+
+void TaskStorage::maybeCompact()
+{
+    if (m_mode != StorageMode::Journaled || m_compacting || m_loading)
+        return;
+
+    if (m_journalRecords >= m_maxJournalRecords || m_journalBytes >= m_maxJournalBytes) {
+        startCompaction();
+    }
+}
+
+void TaskStorage::startCompaction()
+{
+    m_compacting = true;
+    flush(); // Records up to m_seq go out ahead of the snapshot that includes them
+
+    m_recordsBeforeCompaction = m_journalRecords;
+    m_bytesBeforeCompaction = m_journalBytes;
+    m_journalRecords = 0;
+    m_journalBytes = 0;
+
+    // Serialized and written on the writer thread, which also drops the folded-in journal
+    queueSnapshot(true);
+}
+
+void TaskStorage::queueSnapshot(bool journaled)
+{
+    // The copy shares every QString with the live list, so it only costs the vector itself
+    const QString& filename = m_format == SnapshotFormat::Binary ? m_binaryFilenames[m_binarySlot] : m_filename;
+    m_writer->writeSnapshot(m_tasks, m_seq, journaled, m_format, filename);
+}
+
+void TaskStorage::setSnapshotFormat(SnapshotFormat format)
+{
+    // The format on disk is known before streaming starts, so an unchanged one costs nothing
+    if (format == m_format) return;
+
+    // The rewrite needs every task, so it waits for the load instead of blocking on it
+    if (m_loading) {
+        connect(this, &TaskStorage::loadFinished, this, [this, format]() {
+            setSnapshotFormat(format);
+        }, Qt::SingleShotConnection);
+        return;
+    }
+    m_format = format;
+
+    // Rewrite right away so the previous format's file doesn't linger as the newest
+    if (m_mode == StorageMode::Journaled) {
+        startCompaction();
+    } else {
+        m_dirty = true;
+        flush();
+    }
+}
+
+bool TaskStorage::exportJson(const QString& filename)
+{
+    waitForLoad();
+    return saveInternal(filename, m_tasks);
+}
+
+void TaskStorage::onCompactionFinished(bool ok)
+{
+    m_compacting = false;
+
+    // On failure the old snapshot and the full journal are still consistent; retry at the next threshold
+    if (!ok) {
+        m_journalRecords += m_recordsBeforeCompaction;
+        m_journalBytes += m_bytesBeforeCompaction;
+    }
+}
+
+TaskId TaskStorage::add(const QString& task)
+{
+    waitForLoad(); // Mutations apply on top of the fully loaded list and journal
+    if (task.trimmed().isEmpty()) return 0;
 
     auto parsed = SmartParser::parse(task.trimmed());
-    auto tasks = load();
-    tasks.push_back({ parsed.cleanText, false, parsed.alarmTime });
-    saveInternal(m_filename, tasks);
+    TaskItem item{ m_nextId++, parsed.cleanText, false, parsed.alarmTime };
+    m_indexById[item.id] = m_tasks.size();
+    m_tasks.push_back(item);
+
+    QJsonObject record = taskToJson(item);
+    record["op"] = "add";
+    appendRecord(record);
+
+    emit taskInserted(item.id);
+    return item.id;
 }
 
-void TaskStorage::update(int index, const QString& newText)
+void TaskStorage::update(TaskId id, const QString& newText)
 {
+    waitForLoad();
     if (newText.trimmed().isEmpty()) return;
 
-    auto tasks = load();
-    if (index < 0 || static_cast<size_t>(index) >= tasks.size())
+    int index = indexOf(id);
+    if (index < 0)
         return;
 
     auto parsed = SmartParser::parse(newText.trimmed());
-    tasks[index].text = parsed.cleanText;
-    tasks[index].alarmTime = parsed.alarmTime;
-    saveInternal(m_filename, tasks);
+    m_tasks[index].text = parsed.cleanText;
+    m_tasks[index].alarmTime = parsed.alarmTime;
+
+    appendRecord({
+        {"op", "update"},
+        {"id", static_cast<qint64>(id)},
+        {"text", parsed.cleanText},
+        {"alarmTime", parsed.alarmTime}
+    });
+
+    emit taskChanged(id);
 }
 
-void TaskStorage::setCompleted(int index, bool completed)
+void TaskStorage::setCompleted(TaskId id, bool completed)
 {
-    auto tasks = load();
-    if (index < 0 || static_cast<size_t>(index) >= tasks.size())
+    waitForLoad();
+    int index = indexOf(id);
+    if (index < 0)
         return;
 
-    tasks[index].isCompleted = completed;
-    saveInternal(m_filename, tasks);
+    m_tasks[index].isCompleted = completed;
+    m_tasks[index].completedAt = completed ? QDateTime::currentMSecsSinceEpoch() : 0;
+
+    appendRecord({
+        {"op", "complete"},
+        {"id", static_cast<qint64>(id)},
+        {"isCompleted", completed},
+        {"completedAt", m_tasks[index].completedAt}
+    });
+
+    emit taskChanged(id);
 }
 
-void TaskStorage::snooze(int index)
+void TaskStorage::snooze(TaskId id)
 {
-    auto tasks = load();
-    if (index < 0 || static_cast<size_t>(index) >= tasks.size())
+    waitForLoad();
+    int index = indexOf(id);
+    if (index < 0)
         return;
 
-    if (tasks[index].alarmTime > 0) {
+    if (m_tasks[index].alarmTime > 0) {
         // Add 30 minutes (30 * 60 * 1000 = 1800000 ms) to the existing alarm or current time if expired
         qint64 now = QDateTime::currentMSecsSinceEpoch();
-        qint64 baseTime = std::max(tasks[index].alarmTime, now);
-        tasks[index].alarmTime = baseTime + 1800000LL;
-        saveInternal(m_filename, tasks);
+        qint64 baseTime = std::max(m_tasks[index].alarmTime, now);
+        m_tasks[index].alarmTime = baseTime + 1800000LL;
+
+        // Journal the resolved time so replay doesn't depend on when it runs
+        appendRecord({
+            {"op", "snooze"},
+            {"id", static_cast<qint64>(id)},
+            {"alarmTime", m_tasks[index].alarmTime}
+        });
+
+        emit taskChanged(id);
     }
 }
 
-void TaskStorage::remove(int index)
+void TaskStorage::remove(TaskId id)
 {
-    auto tasks = load();
-    
-    if (index < 0 || static_cast<size_t>(index) >= tasks.size())
+    waitForLoad();
+    int index = indexOf(id);
+    if (index < 0)
         return;
 
-    tasks.erase(tasks.begin() + index);
-    saveInternal(m_filename, tasks);
+    eraseAt(index);
+
+    appendRecord({
+        {"op", "remove"},
+        {"id", static_cast<qint64>(id)}
+    });
+
+    emit taskRemoved(id);
+}
+
+void TaskStorage::setArchiveAge(qint64 ms)
+{
+    m_archiveAge = ms;
+    if (m_archiveAge > 0) {
+        m_archiveTimer.start();
+        archiveCompleted();
+    } else {
+        m_archiveTimer.stop();
+    }
+}
+
+void TaskStorage::archiveCompleted()
+{
+    // One archive append in flight at a time, the timer picks up whatever it missed
+    if (m_archiveAge <= 0 || m_loading || !m_archiving.empty())
+        return;
+
+    // Tasks completed before completion times were recorded have no age and stay put
+    qint64 cutoff = QDateTime::currentMSecsSinceEpoch() - m_archiveAge;
+    for (const TaskItem& t : m_tasks) {
+        if (t.isCompleted && t.completedAt > 0 && t.completedAt <= cutoff) {
+            m_archiving.push_back(t);
+        }
+    }
+    if (m_archiving.empty())
+        return;
+
+    QByteArray lines;
+    for (const TaskItem& t : m_archiving) {
+        lines.append(QJsonDocument(taskToJson(t)).toJson(QJsonDocument::Compact));
+        lines.append('\n');
+    }
+    // Closes the batch with the next free id, so a restart never hands out an archived id
+    lines.append(QJsonDocument(QJsonObject{ {"nextId", static_cast<qint64>(m_nextId)} }).toJson(QJsonDocument::Compact));
+    lines.append('\n');
+
+    m_writer->appendArchive(lines, m_archiveFilename);
+}
+
+void TaskStorage::onArchiveFinished(bool ok)
+{
+    std::vector<TaskItem> archived;
+    archived.swap(m_archiving);
+    if (!ok)
+        return; // Nothing left the hot list, the next check tries again
+
+    // A task edited or reopened since it was copied stays, its archived copy is ignored on read
+    std::vector<TaskId> ids;
+    for (const TaskItem& t : archived) {
+        const TaskItem* current = find(t.id);
+        if (current && current->isCompleted && current->completedAt == t.completedAt
+            && current->text == t.text && current->alarmTime == t.alarmTime) {
+            ids.push_back(t.id);
+        }
+    }
+    if (ids.empty())
+        return;
+
+    eraseArchived(ids);
+
+    QJsonArray idArray;
+    for (TaskId id : ids) {
+        idArray.append(static_cast<qint64>(id));
+    }
+    appendRecord({
+        {"op", "archive"},
+        {"ids", idArray}
+    });
+
+    // Views handle a few removals one by one, a first archive of years of history is a rebuild
+    if (ids.size() > 64) {
+        emit reloaded();
+    } else {
+        for (TaskId id : ids) {
+            emit taskRemoved(id);
+        }
+    }
+}
+
+void TaskStorage::eraseArchived(const std::vector<TaskId>& ids)
+{
+    std::unordered_set<TaskId> gone(ids.begin(), ids.end());
+    m_tasks.erase(std::remove_if(m_tasks.begin(), m_tasks.end(), [&gone](const TaskItem& t) {
+        return gone.count(t.id) != 0;
+    }), m_tasks.end());
+
+    // Unlike rebuildIndex, m_nextId stays put: archived ids are never handed out again
+    m_indexById.clear();
+    for (size_t i = 0; i < m_tasks.size(); ++i) {
+        m_indexById.emplace(m_tasks[i].id, i);
+    }
+}
+
+TaskId TaskStorage::readArchivedNextId(const QString& filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return 1;
+
+    // Every batch ends with its next free id, so the tail of the file is normally enough
+    const qint64 kTail = 4096;
+    for (qint64 from : { qMax<qint64>(0, file.size() - kTail), qint64(0) }) {
+        file.seek(from);
+        QList<QByteArray> lines = file.readAll().split('\n');
+        TaskId nextId = 1;
+        for (auto it = lines.rbegin(); it != lines.rend(); ++it) {
+            QJsonObject obj = QJsonDocument::fromJson(*it).object();
+            if (obj.contains("nextId")) {
+                return std::max(nextId, static_cast<TaskId>(obj["nextId"].toInteger(1)));
+            }
+            // Lines after the last marker belong to a batch whose marker never made it, their ids
+            // count too. A tail with no marker at all is dropped and the whole file read instead.
+            nextId = std::max(nextId, static_cast<TaskId>(obj["id"].toInteger(0)) + 1);
+        }
+        if (from == 0) return nextId;
+    }
+    return 1;
+}
+
+std::vector<TaskItem> TaskStorage::loadArchive() const
+{
+    // An append may still be on its way to the file
+    m_writer->waitForIdle();
+
+    std::vector<TaskItem> archived;
+    QFile file(m_archiveFilename);
+    if (!file.open(QIODevice::ReadOnly))
+        return archived;
+
+    std::unordered_map<TaskId, size_t> slots;
+    while (!file.atEnd()) {
+        // A torn last line from a crash mid-append simply fails to parse and is dropped
+        QJsonObject obj = QJsonDocument::fromJson(file.readLine()).object();
+        if (!obj.contains("id"))
+            continue;
+
+        // A task archived again after an earlier failed attempt keeps its first place
+        TaskItem t = taskFromJson(obj);
+        auto [it, inserted] = slots.emplace(t.id, archived.size());
+        if (inserted) {
+            archived.push_back(t);
+        } else {
+            archived[it->second] = t;
+        }
+    }
+
+    // Copies of tasks that never left the hot list are stale
+    archived.erase(std::remove_if(archived.begin(), archived.end(), [this](const TaskItem& t) {
+        return m_indexById.count(t.id) != 0;
+    }), archived.end());
+    return archived;
 }
@@ -0,0 +1,278 @@
+#include "utils/FuzzyMatcher.h"
+#include <QtAlgorithms>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define FUZZY_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define FUZZY_AVX2_TARGET
+#else
+#define FUZZY_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+// Scoring follows fzf's v1 algorithm
+const int kScoreMatch = 16;
+const int kGapStart = 3;
+const int kGapExtension = 1;
+const int kBonusBoundary = kScoreMatch / 2;       // Match right after a space or punctuation
+const int kBonusConsecutive = kGapStart + kGapExtension;
+const int kFirstCharMultiplier = 2;
+
+using FindFn = int (*)(const char16_t* s, int from, int length, char16_t c);
+
+int findScalar(const char16_t* s, int from, int length, char16_t c)
+{
+    for (int i = from; i < length; ++i) {
+        if (s[i] == c) return i;
+    }
+    return -1;
+}
+
+#ifdef FUZZY_X86
+int findSse2(const char16_t* s, int from, int length, char16_t c)
+{
+    const __m128i needle = _mm_set1_epi16(static_cast<short>(c));
+    int i = from;
+    for (; i + 8 <= length; i += 8) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        int hits = _mm_movemask_epi8(_mm_cmpeq_epi16(block, needle));
+        if (hits) return i + qCountTrailingZeroBits(static_cast<quint32>(hits)) / 2;
+    }
+    return findScalar(s, i, length, c);
+}
+
+FUZZY_AVX2_TARGET int findAvx2(const char16_t* s, int from, int length, char16_t c)
+{
+    const __m256i needle = _mm256_set1_epi16(static_cast<short>(c));
+    int i = from;
+    for (; i + 16 <= length; i += 16) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        int hits = _mm256_movemask_epi8(_mm256_cmpeq_epi16(block, needle));
+        if (hits) return i + qCountTrailingZeroBits(static_cast<quint32>(hits)) / 2;
+    }
+    return findSse2(s, i, length, c);
+}
+
+bool hasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    // AVX2 needs the CPU flag and the OS saving the YMM registers
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5));
+#else
+    // Runs from a static initializer, possibly before libgcc has filled in the CPU model
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+FindFn pickFind(const char** name)
+{
+#ifdef FUZZY_X86
+    if (hasAvx2()) {
+        *name = "avx2";
+        return findAvx2;
+    }
+    *name = "sse2";
+    return findSse2;
+#else
+    *name = "scalar";
+    return findScalar;
+#endif
+}
+
+const char* s_instructionSet = "scalar";
+const FindFn findChar = pickFind(&s_instructionSet);
+
+bool isBoundary(const char16_t* text, int i)
+{
+    return i == 0 || !QChar(text[i - 1]).isLetterOrNumber();
+}
+}
+
+const char* FuzzyMatcher::instructionSet()
+{
+    return s_instructionSet;
+}
+
+quint64 FuzzyMatcher::maskOf(const char16_t* s, qsizetype length)
+{
+    quint64 mask = 0;
+    for (qsizetype i = 0; i < length; ++i) {
+        mask |= quint64(1) << (s[i] & 63);
+    }
+    return mask;
+}
+
+int FuzzyMatcher::score(const char16_t* text, int length, const char16_t* query, int queryLength)
+{
+    if (queryLength == 0) return 0;
+
+    // Forward: the earliest position where the whole query has appeared in order
+    int pos = 0;
+    for (int k = 0; k < queryLength; ++k) {
+        pos = findChar(text, pos, length, query[k]);
+        if (pos < 0) return 0;
+        pos++;
+    }
+    int end = pos - 1;
+
+    // Backward from there: the latest start, so the scored span is as tight as possible
+    int start = end;
+    for (int i = end, k = queryLength - 1; i >= 0; --i) {
+        if (text[i] == query[k] && --k < 0) {
+            start = i;
+            break;
+        }
+    }
+
+    int total = 0;
+    int k = 0;
+    bool inGap = false;
+    bool consecutive = false;
+    for (int i = start; i <= end; ++i) {
+        if (k < queryLength && text[i] == query[k]) {
+            int bonus = isBoundary(text, i) ? kBonusBoundary : 0;
+            if (consecutive) bonus = std::max(bonus, kBonusConsecutive);
+            if (k == 0) bonus *= kFirstCharMultiplier;
+            total += kScoreMatch + bonus;
+            consecutive = true;
+            inGap = false;
+            k++;
+        } else {
+            total -= inGap ? kGapExtension : kGapStart;
+            consecutive = false;
+            inGap = true;
+        }
+    }
+    return std::max(total, 1);
+}
+
+int FuzzyMatcher::score(const QString& text, const QString& query)
+{
+    QString foldedText = text.toCaseFolded();
+    QString foldedQuery = query.toCaseFolded();
+    return score(foldedText.utf16(), static_cast<int>(foldedText.size()),
+                 foldedQuery.utf16(), static_cast<int>(foldedQuery.size()));
+}
+
+void FuzzyMatcher::clear()
+{
+    m_chars.clear();
+    m_entries.clear();
+    m_slots.clear();
+    m_removed = 0;
+}
+
+void FuzzyMatcher::insert(TaskId id, const QString& text)
+{
+    QString folded = text.toCaseFolded();
+    const char16_t* s = folded.utf16();
+
+    Entry entry;
+    entry.id = id;
+    entry.offset = static_cast<quint32>(m_chars.size());
+    entry.length = static_cast<quint32>(folded.size());
+    entry.mask = maskOf(s, folded.size());
+    m_chars.insert(m_chars.end(), s, s + folded.size());
+
+    m_slots[id] = m_entries.size();
+    m_entries.push_back(entry);
+}
+
+void FuzzyMatcher::update(TaskId id, const QString& text)
+{
+    auto it = m_slots.find(id);
+    if (it == m_slots.end()) {
+        insert(id, text);
+        return;
+    }
+
+    // Completing or snoozing a task leaves its text alone, and a shorter text fits in place
+    Entry& entry = m_entries[it->second];
+    QString folded = text.toCaseFolded();
+    const char16_t* s = folded.utf16();
+    char16_t* stored = m_chars.data() + entry.offset;
+    if (static_cast<quint32>(folded.size()) == entry.length && std::equal(s, s + folded.size(), stored)) {
+        return;
+    }
+    if (static_cast<quint32>(folded.size()) <= entry.length) {
+        std::copy(s, s + folded.size(), stored);
+        entry.length = static_cast<quint32>(folded.size());
+        entry.mask = maskOf(s, folded.size());
+        return;
+    }
+
+    remove(id);
+    insert(id, text);
+}
+
+void FuzzyMatcher::remove(TaskId id)
+{
+    auto it = m_slots.find(id);
+    if (it == m_slots.end()) return;
+
+    m_entries[it->second].id = 0;
+    m_slots.erase(it);
+    m_removed++;
+
+    // Longer edits append a fresh copy, so reclaim the dead text once most entries are dead
+    if (m_removed > m_entries.size() / 2) {
+        compact();
+    }
+}
+
+void FuzzyMatcher::compact()
+{
+    std::vector<char16_t> chars;
+    std::vector<Entry> entries;
+    chars.reserve(m_chars.size());
+    entries.reserve(m_slots.size());
+
+    for (Entry entry : m_entries) {
+        if (entry.id == 0) continue;
+        const char16_t* s = m_chars.data() + entry.offset;
+        entry.offset = static_cast<quint32>(chars.size());
+        chars.insert(chars.end(), s, s + entry.length);
+        m_slots[entry.id] = entries.size();
+        entries.push_back(entry);
+    }
+
+    m_chars.swap(chars);
+    m_entries.swap(entries);
+    m_removed = 0;
+}
+
+std::vector<FuzzyMatcher::Match> FuzzyMatcher::search(const QString& query) const
+{
+    std::vector<Match> matches;
+    QString folded = query.toCaseFolded();
+    if (folded.isEmpty()) return matches;
+
+    const char16_t* q = folded.utf16();
+    const int queryLength = static_cast<int>(folded.size());
+    const quint64 queryMask = maskOf(q, queryLength);
+
+    for (const Entry& entry : m_entries) {
+        // Any query character missing from the text rules it out before scanning
+        if (entry.id == 0 || (entry.mask & queryMask) != queryMask) continue;
+
+        int s = score(m_chars.data() + entry.offset, static_cast<int>(entry.length), q, queryLength);
+        if (s > 0) matches.push_back({ entry.id, s });
+    }
+
+    std::stable_sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        return a.score > b.score;
+    });
+    return matches;
+}
@@ -1,31 +1,260 @@
 #include "utils/SmartParser.h"
-#include <QRegularExpression>
 #include <QDateTime>
+#include <QStringView>
+#include <algorithm>
+#include <climits>
 
-ParsedTask SmartParser::parse(const QString& rawText) {
+namespace {
+
+struct DurationUnit {
+    const char* name;
+    qint64 ms;
+};
+
+// Add new duration units here; names are matched case-insensitively as whole words
+const DurationUnit kDurationUnits[] = {
+    { "m", 60 * 1000LL },
+    { "min", 60 * 1000LL },
+    { "mins", 60 * 1000LL },
+    { "minute", 60 * 1000LL },
+    { "minutes", 60 * 1000LL },
+    { "h", 60 * 60 * 1000LL },
+    { "hr", 60 * 60 * 1000LL },
+    { "hrs", 60 * 60 * 1000LL },
+    { "hour", 60 * 60 * 1000LL },
+    { "hours", 60 * 60 * 1000LL },
+    { "d", 24 * 60 * 60 * 1000LL },
+    { "day", 24 * 60 * 60 * 1000LL },
+    { "days", 24 * 60 * 60 * 1000LL },
+};
+
+inline bool isDigit(QChar c)
+{
+    return c.unicode() >= '0' && c.unicode() <= '9';
+}
+
+inline bool isWordChar(QChar c)
+{
+    char16_t u = c.unicode();
+    return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || (u >= '0' && u <= '9') || u == '_';
+}
+
+inline bool isSpace(QChar c)
+{
+    char16_t u = c.unicode();
+    return u == ' ' || u == '\t' || u == '\n' || u == '\r' || u == '\f' || u == '\v';
+}
+
+bool equalsIgnoreCase(QStringView s, const char* word)
+{
+    qsizetype i = 0;
+    for (; word[i]; ++i) {
+        if (i >= s.size()) return false;
+        char16_t u = s[i].unicode();
+        if (u >= 'A' && u <= 'Z') u += 'a' - 'A';
+        if (u != static_cast<char16_t>(word[i])) return false;
+    }
+    return i == s.size();
+}
+
+// Cursor over the text. Every method either consumes what it matched and returns true,
+// or leaves the position untouched, so phrase matchers can try alternatives cheaply.
+class Scanner {
+public:
+    explicit Scanner(QStringView text, qsizetype pos = 0) : m_text(text), m_pos(pos) {}
+
+    qsizetype pos() const { return m_pos; }
+    bool atEnd() const { return m_pos >= m_text.size(); }
+    bool atWordBoundary() const { return atEnd() || !isWordChar(m_text[m_pos]); }
+    bool atDigit() const { return !atEnd() && isDigit(m_text[m_pos]); }
+
+    // Rest of the current run of word characters
+    QStringView wordRest() const
+    {
+        qsizetype end = m_pos;
+        while (end < m_text.size() && isWordChar(m_text[end])) ++end;
+        return m_text.sliced(m_pos, end - m_pos);
+    }
+
+    int skipSpaces()
+    {
+        int count = 0;
+        while (!atEnd() && isSpace(m_text[m_pos])) { ++m_pos; ++count; }
+        return count;
+    }
+
+    bool skipChar(char16_t c)
+    {
+        if (atEnd() || m_text[m_pos].unicode() != c) return false;
+        ++m_pos;
+        return true;
+    }
+
+    // A whole word, i.e. the remainder of the current word run must be exactly `word`
+    bool word(const char* word)
+    {
+        QStringView rest = wordRest();
+        if (!equalsIgnoreCase(rest, word)) return false;
+        m_pos += rest.size();
+        return true;
+    }
+
+    // Leading digits of the current word run; `value` is -1 if it doesn't fit an int
+    bool number(int& value, int& digits)
+    {
+        qsizetype end = m_pos;
+        qint64 acc = 0;
+        while (end < m_text.size() && isDigit(m_text[end])) {
+            if (acc <= INT_MAX) acc = acc * 10 + (m_text[end].unicode() - '0');
+            ++end;
+        }
+        if (end == m_pos) return false;
+        digits = static_cast<int>(end - m_pos);
+        value = acc <= INT_MAX ? static_cast<int>(acc) : -1;
+        m_pos = end;
+        return true;
+    }
+
+private:
+    QStringView m_text;
+    qsizetype m_pos;
+};
+
+enum class Match { None, Found, Invalid };
+
+// "in [exactly] N <unit>". Mirrors the old regex \b(?:in(?: exactly)?)\s+(\d+)\s*(unit)\b,
+// including that a matched phrase with a zero or unparsable amount yields no alarm.
+Match matchRelative(Scanner s, qint64 now, qint64& alarmTime)
+{
+    if (!s.word("in")) return Match::None;
+
+    Scanner withExactly = s;
+    if (withExactly.skipChar(' ') && withExactly.word("exactly") && withExactly.skipSpaces() > 0 && withExactly.atDigit()) {
+        s = withExactly;
+    } else if (s.skipSpaces() == 0) {
+        return Match::None;
+    }
+
+    int amount = 0;
+    int digits = 0;
+    if (!s.number(amount, digits)) return Match::None;
+    s.skipSpaces();
+
+    for (const auto& unit : kDurationUnits) {
+        Scanner u = s;
+        if (u.word(unit.name)) {
+            if (amount <= 0) return Match::Invalid;
+            alarmTime = now + amount * unit.ms;
+            return Match::Found;
+        }
+    }
+    return Match::None;
+}
+
+// H[:MM] [am|pm], e.g. "17:30", "9am", "9:15 pm". A bare hour needs am/pm.
+bool matchClockTime(Scanner& s, int& hour, int& minute)
+{
+    Scanner t = s;
+    int digits = 0;
+    if (!t.number(hour, digits) || digits > 2) return false;
+
+    minute = 0;
+    bool hasMinutes = false;
+    if (t.atWordBoundary() && t.skipChar(':')) {
+        if (!t.number(minute, digits) || digits != 2 || minute > 59) return false;
+        hasMinutes = true;
+    }
+
+    Scanner meridiem = t;
+    meridiem.skipSpaces();
+    bool am = meridiem.word("am");
+    bool pm = !am && meridiem.word("pm");
+    if (am || pm) {
+        if (hour < 1 || hour > 12) return false;
+        hour = (hour % 12) + (pm ? 12 : 0);
+        t = meridiem;
+    } else if (!hasMinutes || hour > 23) {
+        return false;
+    }
+
+    if (!t.atWordBoundary()) return false;
+    s = t;
+    return true;
+}
+
+qint64 nextWallClock(qint64 now, int hour, int minute, bool tomorrow)
+{
+    QDateTime base = QDateTime::fromMSecsSinceEpoch(now);
+    QDate date = base.date();
+    if (tomorrow) date = date.addDays(1);
+
+    QDateTime target(date, QTime(hour, minute));
+    if (!tomorrow && target.toMSecsSinceEpoch() <= now) {
+        target = target.addDays(1); // "at 9am" after 9am means tomorrow morning
+    }
+    return target.toMSecsSinceEpoch();
+}
+
+// "at TIME", "tomorrow TIME", "tomorrow at TIME"
+Match matchAbsolute(Scanner s, qint64 now, qint64& alarmTime)
+{
+    bool tomorrow = false;
+    if (s.word("tomorrow")) {
+        tomorrow = true;
+        if (s.skipSpaces() == 0) return Match::None;
+        Scanner at = s;
+        if (at.word("at") && at.skipSpaces() > 0) s = at;
+    } else if (!s.word("at") || s.skipSpaces() == 0) {
+        return Match::None;
+    }
+
+    int hour = 0;
+    int minute = 0;
+    if (!matchClockTime(s, hour, minute)) return Match::None;
+
+    alarmTime = nextWallClock(now, hour, minute, tomorrow);
+    return Match::Found;
+}
+
+}
+
+ParsedTask SmartParser::parse(const QString& rawText)
+{
+    return parse(rawText, QDateTime::currentMSecsSinceEpoch());
+}
+
+ParsedTask SmartParser::parse(const QString& rawText, qint64 now)
+{
     ParsedTask result;
     result.cleanText = rawText;
     result.alarmTime = 0;
 
-    // Detect patterns like "in 15m", "in 15 mins", "in 1h"
-    QRegularExpression re(R"(\b(?:in(?: exactly)?)\s+(\d+)\s*(m|min|mins|minutes|h|hr|hrs|hours)\b)", QRegularExpression::CaseInsensitiveOption);
-    QRegularExpressionMatch match = re.match(rawText);
-    
-    if (match.hasMatch()) {
-        int amount = match.captured(1).toInt();
-        QString unit = match.captured(2).toLower();
-        
-        qint64 msToAdd = 0;
-        if (unit.startsWith("m")) {
-            msToAdd = amount * 60 * 1000LL;
-        } else if (unit.startsWith("h")) {
-            msToAdd = amount * 60 * 60 * 1000LL;
+    QStringView text(rawText);
+    qsizetype pos = 0;
+    while (pos < text.size()) {
+        // Phrases can only start at the beginning of a word
+        if (!isWordChar(text[pos]) || (pos > 0 && isWordChar(text[pos - 1]))) {
+            ++pos;
+            continue;
         }
 
-        if (msToAdd > 0) {
-            result.alarmTime = QDateTime::currentMSecsSinceEpoch() + msToAdd;
-            // Optionally, we could strip the "in 15m" from the text here, but keeping it is good for visibility.
+        Scanner at(text, pos);
+        qint64 alarmTime = 0;
+        Match match = matchRelative(at, now, alarmTime);
+        if (match == Match::None) {
+            match = matchAbsolute(at, now, alarmTime);
         }
+
+        if (match == Match::Found) {
+            // Keeping the phrase in the text is good for visibility, so it isn't stripped
+            result.alarmTime = alarmTime;
+            return result;
+        }
+        if (match == Match::Invalid) {
+            return result;
+        }
+
+        pos += std::max<qsizetype>(1, at.wordRest().size());
     }
 
     return result;
@@ -0,0 +1,22 @@
+#include "utils/TaskOrdering.h"
+
+bool TaskOrdering::isUrgent(const TaskItem& task, qint64 now)
+{
+    return !task.isCompleted && task.alarmTime > 0 && now >= task.alarmTime;
+}
+
+TaskOrdering::Bucket TaskOrdering::bucketOf(const TaskItem& task, qint64 now)
+{
+    return bucketOf(task, isUrgent(task, now));
+}
+
+TaskOrdering::Bucket TaskOrdering::bucketOf(const TaskItem& task, bool urgent)
+{
+    if (task.isCompleted) return Completed;
+    return urgent ? Urgent : Open;
+}
+
+std::vector<TaskId> TaskOrdering::displayOrder(const std::vector<TaskItem>& tasks, qint64 now)
+{
+    return displayOrder(tasks, [now](const TaskItem& task) { return isUrgent(task, now); });
+}
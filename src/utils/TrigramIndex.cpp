@@ -0,0 +1,122 @@
+#include "utils/TrigramIndex.h"
+#include <algorithm>
+#include <iterator>
+
+std::vector<TrigramIndex::Gram> TrigramIndex::gramsOf(const QString& folded)
+{
+    std::vector<Gram> grams;
+    if (folded.size() < 3) return grams;
+
+    grams.reserve(folded.size() - 2);
+    const char16_t* s = folded.utf16();
+    for (qsizetype i = 0; i + 2 < folded.size(); ++i) {
+        grams.push_back(Gram(s[i]) << 32 | Gram(s[i + 1]) << 16 | Gram(s[i + 2]));
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+void TrigramIndex::clear()
+{
+    m_postings.clear();
+    m_texts.clear();
+}
+
+void TrigramIndex::insert(TaskId id, const QString& text)
+{
+    QString folded = text.toCaseFolded();
+    for (Gram gram : gramsOf(folded)) {
+        // New tasks get the highest id so far, which makes this an append
+        std::vector<TaskId>& ids = m_postings[gram];
+        ids.insert(std::lower_bound(ids.begin(), ids.end(), id), id);
+    }
+    m_texts[id] = std::move(folded);
+}
+
+void TrigramIndex::update(TaskId id, const QString& text)
+{
+    auto it = m_texts.find(id);
+    if (it == m_texts.end()) {
+        insert(id, text);
+        return;
+    }
+
+    QString folded = text.toCaseFolded();
+    if (folded == it->second) return; // Completion or alarm change
+
+    // Only the grams that appear or disappear touch their lists
+    std::vector<Gram> before = gramsOf(it->second);
+    std::vector<Gram> after = gramsOf(folded);
+    std::vector<Gram> gone, added;
+    std::set_difference(before.begin(), before.end(), after.begin(), after.end(), std::back_inserter(gone));
+    std::set_difference(after.begin(), after.end(), before.begin(), before.end(), std::back_inserter(added));
+
+    for (Gram gram : gone) {
+        std::vector<TaskId>& ids = m_postings[gram];
+        ids.erase(std::lower_bound(ids.begin(), ids.end(), id));
+        if (ids.empty()) m_postings.erase(gram);
+    }
+    for (Gram gram : added) {
+        std::vector<TaskId>& ids = m_postings[gram];
+        ids.insert(std::lower_bound(ids.begin(), ids.end(), id), id);
+    }
+    it->second = std::move(folded);
+}
+
+void TrigramIndex::remove(TaskId id)
+{
+    auto it = m_texts.find(id);
+    if (it == m_texts.end()) return;
+
+    for (Gram gram : gramsOf(it->second)) {
+        std::vector<TaskId>& ids = m_postings[gram];
+        ids.erase(std::lower_bound(ids.begin(), ids.end(), id));
+        if (ids.empty()) m_postings.erase(gram);
+    }
+    m_texts.erase(it);
+}
+
+bool TrigramIndex::matches(TaskId id, const QString& query) const
+{
+    auto it = m_texts.find(id);
+    return it != m_texts.end() && it->second.contains(query.toCaseFolded());
+}
+
+std::vector<TaskId> TrigramIndex::search(const QString& query) const
+{
+    QString folded = query.toCaseFolded();
+    std::vector<TaskId> result;
+
+    // Too short to have a gram: check every text
+    if (folded.size() < 3) {
+        for (const auto& [id, text] : m_texts) {
+            if (text.contains(folded)) result.push_back(id);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<const std::vector<TaskId>*> lists;
+    for (Gram gram : gramsOf(folded)) {
+        auto it = m_postings.find(gram);
+        if (it == m_postings.end()) return result;
+        lists.push_back(&it->second);
+    }
+
+    // Start from the rarest gram, so every intersection only shrinks a short list
+    std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+    std::vector<TaskId> candidates = *lists.front();
+    std::vector<TaskId> narrowed;
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+        narrowed.clear();
+        std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(narrowed));
+        candidates.swap(narrowed);
+    }
+
+    // Grams can match out of order ("abcab" has the grams of "cabc"), so confirm each one
+    for (TaskId id : candidates) {
+        if (m_texts.at(id).contains(folded)) result.push_back(id);
+    }
+    return result;
+}
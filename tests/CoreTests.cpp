@@ -0,0 +1,144 @@
+// Unit tests for minitasks_core: the alarm phrase scanner, the block-wise tasks.json
+// reader and journal replay. Run through ctest, or directly as minitasks_core_tests.
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QDateTime>
+#include <QFile>
+#include "TaskStorage.h"
+#include "JsonTaskReader.h"
+#include "utils/SmartParser.h"
+
+namespace {
+qint64 localTime(QDate date, QTime time)
+{
+    return QDateTime(date, time).toMSecsSinceEpoch();
+}
+
+const qint64 kNow = localTime(QDate(2024, 3, 10), QTime(12, 0));
+const qint64 kMinute = 60 * 1000LL;
+}
+
+class CoreTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void smartParser_data();
+    void smartParser();
+    void jsonReaderAcrossBlocks_data();
+    void jsonReaderAcrossBlocks();
+    void journalReplayAfterTornLine();
+};
+
+// The cases the regex parser handled, which the scanner has to keep
+void CoreTests::smartParser_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<qint64>("alarmTime");
+
+    QTest::newRow("in 5m") << "Call mom in 5m" << kNow + 5 * kMinute;
+    QTest::newRow("in exactly 2 hours") << "Stand-up in exactly 2 hours" << kNow + 120 * kMinute;
+    QTest::newRow("no word boundary") << "login 5m" << qint64(0);
+    QTest::newRow("zero amount") << "in 0m" << qint64(0);
+    QTest::newRow("at 9:05pm") << "Dinner at 9:05pm" << localTime(QDate(2024, 3, 10), QTime(21, 5));
+    QTest::newRow("tomorrow without a time") << "tomorrow" << qint64(0);
+    QTest::newRow("tomorrow 9am") << "Gym tomorrow 9am" << localTime(QDate(2024, 3, 11), QTime(9, 0));
+}
+
+void CoreTests::smartParser()
+{
+    QFETCH(QString, text);
+    QFETCH(qint64, alarmTime);
+
+    ParsedTask parsed = SmartParser::parse(text, kNow);
+    QCOMPARE(parsed.alarmTime, alarmTime);
+    QCOMPARE(parsed.cleanText, text);
+}
+
+void CoreTests::jsonReaderAcrossBlocks_data()
+{
+    QTest::addColumn<bool>("parallel");
+    QTest::newRow("sequential") << false;
+    QTest::newRow("parallel") << true;
+}
+
+void CoreTests::jsonReaderAcrossBlocks()
+{
+    QFETCH(bool, parallel);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString filename = dir.filePath("tasks.json");
+
+    // The first text runs past the 64 KiB read size, with braces, quotes and escapes
+    // right around the boundary; the small tasks after it straddle later blocks too
+    std::vector<TaskItem> tasks;
+    tasks.push_back({ 1, QString(65500, 'x') + "{\"}\\[]" + QString(200, 'y'), false, 0, 0 });
+    for (int i = 0; i < 3000; ++i) {
+        tasks.push_back({ TaskId(i + 2), QString("task %1 {\"}").arg(i), i % 3 == 0, i % 5 == 0 ? 1000 + i : 0, 0 });
+    }
+    QVERIFY(saveInternal(filename, tasks, 7));
+
+    JsonTaskReader reader(filename);
+    reader.setParallel(parallel);
+    QVERIFY(reader.open());
+    std::vector<TaskItem> read;
+    while (!reader.atEnd()) {
+        reader.readChunk(read, 2048);
+    }
+
+    QCOMPARE(reader.seq(), qint64(7));
+    QCOMPARE(read.size(), tasks.size());
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        QCOMPARE(read[i].id, tasks[i].id);
+        QCOMPARE(read[i].text, tasks[i].text);
+        QCOMPARE(read[i].isCompleted, tasks[i].isCompleted);
+        QCOMPARE(read[i].alarmTime, tasks[i].alarmTime);
+    }
+}
+
+void CoreTests::journalReplayAfterTornLine()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString journal = dir.filePath("tasks.journal");
+
+    TaskId first = 0;
+    TaskId second = 0;
+    {
+        TaskStorage storage(dir.path());
+        first = storage.add("first");
+        second = storage.add("second");
+        storage.setCompleted(first, true);
+        storage.sync();
+    }
+    QVERIFY(QFile::exists(journal));
+
+    // A crash mid-append leaves half a record without its newline
+    {
+        QFile file(journal);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+        file.write("{\"op\":\"add\",\"id\":99,\"text\":\"tor");
+    }
+
+    {
+        TaskStorage storage(dir.path());
+        storage.waitForLoad();
+        QCOMPARE(storage.tasks().size(), size_t(2));
+        QVERIFY(storage.find(first)->isCompleted);
+        QCOMPARE(storage.find(second)->text, QString("second"));
+        QVERIFY(!storage.find(99));
+
+        // Appended after the torn line, so it must survive the next replay
+        storage.add("third");
+        storage.sync();
+    }
+
+    TaskStorage storage(dir.path());
+    storage.waitForLoad();
+    QCOMPARE(storage.tasks().size(), size_t(3));
+    QCOMPARE(storage.tasks().back().text, QString("third"));
+}
+
+QTEST_GUILESS_MAIN(CoreTests)
+#include "CoreTests.moc"